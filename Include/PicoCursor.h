@@ -0,0 +1,235 @@
+/*
+ * PICO Manager Library - Directive cursor
+ *
+ * Walks the directive stream of a vault in either format, one directive at a
+ * time. Compact records are expanded back into the directives they stand for,
+ * so callers see the same fields whichever format the vault uses. Shared by
+ * the loader and the host-side tools; plain C types only, like PicoFormat.h.
+ *
+ * The loader trusts its vaults and walks them unchecked. Tools that read
+ * vaults from disk define PICO_CURSOR_CHECKED before including this file and
+ * set end before PicoCursorInit; every read is then bounds checked, LL and
+ * GPA arguments must end in a NUL inside their directive (or the string
+ * table), and a stream that breaks either rule sets malformed and stops the
+ * walk.
+ */
+
+#ifndef PICO_CURSOR_H
+#define PICO_CURSOR_H
+
+#include "PicoFormat.h"
+
+typedef struct {
+	char * next;        /* full format: next directive, compact format: next byte of the stream */
+	char * strings;     /* compact format: string table (NULL for the full format) */
+	char * record;      /* start of the current directive, or of the record it came from */
+	int    remaining;   /* compact format: directives left in the current record */
+#ifdef PICO_CURSOR_CHECKED
+	char * end;         /* one past the last byte of the vault, set by the caller */
+	char * stringsEnd;  /* compact format: one past the string table */
+	int    malformed;   /* set once a read would pass end */
+#endif
+
+	int    type;
+	int    option;
+	int    offset;      /* PATCH, PATCH_DIFF, PATCH_FUNC and EXPORT */
+	int    src_offset;  /* COPY */
+	int    dst_offset;  /* COPY */
+	int    total;       /* COPY */
+	int    tag;         /* EXPORT */
+	char * arg;         /* LL and GPA */
+} PICO_CURSOR;
+
+#ifdef PICO_CURSOR_CHECKED
+#define PICO_CURSOR_FITS(cursor, at, size) ((at) + (size) <= (cursor)->end)
+#else
+#define PICO_CURSOR_FITS(cursor, at, size) 1
+#endif
+
+/*
+ * Stops a checked walk: the stream ends here.
+ */
+static int PicoCursorFail(PICO_CURSOR * cursor) {
+#ifdef PICO_CURSOR_CHECKED
+	cursor->malformed = 1;
+	cursor->next      = cursor->end;
+#endif
+	return 0;
+}
+
+/*
+ * Does the LL/GPA argument end in a NUL before limit? Always true for an unchecked walk.
+ */
+static int PicoCursorTerminated(PICO_CURSOR * cursor, char * limit) {
+#ifdef PICO_CURSOR_CHECKED
+	for (char * at = cursor->arg; at < limit; at++) {
+		if (*at == '\0')
+			return 1;
+	}
+	return 0;
+#else
+	return 1;
+#endif
+}
+
+static unsigned int PicoVarint(PICO_CURSOR * cursor) {
+	unsigned int    value = 0;
+	int             shift = 0;
+	unsigned char   byte;
+
+	do {
+		if (!PICO_CURSOR_FITS(cursor, cursor->next, 1))
+			return PicoCursorFail(cursor);
+
+		byte   = *(unsigned char *)cursor->next++;
+		value |= (unsigned int)(byte & 0x7F) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+
+	return value;
+}
+
+static void PicoCursorInit(PICO_CURSOR * cursor, char * src) {
+	PICO_DIRECTIVE_HDR * first = FIRST_PICO_DIRECTIVE(src);
+
+	cursor->remaining = 0;
+	cursor->strings   = NULL;
+	cursor->next      = (char *)first;
+	cursor->type      = PICO_INST_COMPLETE;
+	cursor->option    = 0;
+	cursor->offset    = 0;
+#ifdef PICO_CURSOR_CHECKED
+	cursor->malformed = 0;
+#endif
+
+	if (!PICO_CURSOR_FITS(cursor, (char *)first, (int)sizeof(PICO_DIRECTIVE_HDR))) {
+		PicoCursorFail(cursor);
+		return;
+	}
+
+	if (first->type == PICO_INST_COMPACT) {
+		unsigned int size;
+
+		if (!PICO_CURSOR_FITS(cursor, (char *)first, (int)sizeof(PICO_DIRECTIVE_COMPACT))) {
+			PicoCursorFail(cursor);
+			return;
+		}
+
+		cursor->next    = (char *)first + sizeof(PICO_DIRECTIVE_COMPACT);
+		size            = PicoVarint(cursor);
+		cursor->strings = cursor->next;
+
+		if (!PICO_CURSOR_FITS(cursor, cursor->next, size)) {
+			PicoCursorFail(cursor);
+			return;
+		}
+
+		cursor->next += size;
+#ifdef PICO_CURSOR_CHECKED
+		cursor->stringsEnd = cursor->next;
+#endif
+	}
+}
+
+/*
+ * Step to the next directive. Returns 0 at PICO_INST_COMPLETE, with next pointing right after
+ * the directive stream. Also returns 0 on an unknown compact record, with type left at it, and
+ * on a checked stream that overruns end, with malformed set.
+ */
+static int PicoCursorNext(PICO_CURSOR * cursor) {
+	if (cursor->strings == NULL) {
+		PICO_DIRECTIVE_HDR * entry = (PICO_DIRECTIVE_HDR *)cursor->next;
+
+		if (!PICO_CURSOR_FITS(cursor, cursor->next, (int)sizeof(PICO_DIRECTIVE_HDR)))
+			return PicoCursorFail(cursor);
+
+		cursor->record = cursor->next;
+		cursor->type   = entry->type;
+		cursor->option = entry->option;
+
+		if (entry->type == PICO_INST_COMPLETE) {
+			cursor->next = (char *)entry + sizeof(PICO_DIRECTIVE_HDR);
+			return 0;
+		}
+
+		if (entry->length < (int)sizeof(PICO_DIRECTIVE_HDR) || !PICO_CURSOR_FITS(cursor, cursor->next, entry->length))
+			return PicoCursorFail(cursor);
+
+		if (entry->type == PICO_INST_PATCH || entry->type == PICO_INST_PATCH_DIFF || entry->type == PICO_INST_PATCH_FUNC) {
+			cursor->offset = ((PICO_DIRECTIVE_PATCH *)entry)->offset;
+		}
+		else if (entry->type == PICO_INST_COPY) {
+			cursor->src_offset = ((PICO_DIRECTIVE_COPY *)entry)->src_offset;
+			cursor->dst_offset = ((PICO_DIRECTIVE_COPY *)entry)->dst_offset;
+			cursor->total      = ((PICO_DIRECTIVE_COPY *)entry)->total;
+		}
+		else if (entry->type == PICO_INST_LL || entry->type == PICO_INST_GPA) {
+			cursor->arg = (char *)entry + sizeof(PICO_DIRECTIVE_HDR);
+
+			if (!PicoCursorTerminated(cursor, (char *)entry + entry->length))
+				return PicoCursorFail(cursor);
+		}
+		else if (entry->type == PICO_INST_EXPORT) {
+			cursor->tag    = ((PICO_DIRECTIVE_EXPORT *)entry)->tag;
+			cursor->offset = ((PICO_DIRECTIVE_EXPORT *)entry)->offset;
+		}
+
+		cursor->next = (char *)entry + entry->length;
+		return 1;
+	}
+
+	while (cursor->remaining == 0) {
+		if (!PICO_CURSOR_FITS(cursor, cursor->next, 1))
+			return PicoCursorFail(cursor);
+
+		cursor->record = cursor->next;
+		cursor->type   = *(unsigned char *)cursor->next++;
+
+		if (cursor->type == PICO_INST_COMPLETE)
+			return 0;
+
+		if (!PICO_CURSOR_FITS(cursor, cursor->next, 1))
+			return PicoCursorFail(cursor);
+
+		cursor->option    = *(char *)cursor->next++;
+		cursor->remaining = (int)PicoVarint(cursor);
+		cursor->offset    = 0;
+	}
+
+	cursor->remaining--;
+
+	if (cursor->type == PICO_INST_PATCH || cursor->type == PICO_INST_PATCH_DIFF || cursor->type == PICO_INST_PATCH_FUNC) {
+		cursor->offset += PicoVarint(cursor);
+	}
+	else if (cursor->type == PICO_INST_COPY) {
+		cursor->src_offset = PicoVarint(cursor);
+		cursor->dst_offset = PicoVarint(cursor);
+		cursor->total      = PicoVarint(cursor);
+	}
+	else if (cursor->type == PICO_INST_LL || cursor->type == PICO_INST_GPA) {
+		unsigned int offset = PicoVarint(cursor);
+		cursor->arg         = cursor->strings + offset;
+
+#ifdef PICO_CURSOR_CHECKED
+		if (offset >= (unsigned int)(cursor->stringsEnd - cursor->strings) || !PicoCursorTerminated(cursor, cursor->stringsEnd))
+			return PicoCursorFail(cursor);
+#endif
+	}
+	else if (cursor->type == PICO_INST_EXPORT) {
+		unsigned int tag = PicoVarint(cursor);
+		cursor->tag      = (int)(tag >> 1) ^ -(int)(tag & 1);
+		cursor->offset   = PicoVarint(cursor);
+	}
+	else {
+		/* items of an unknown record cannot be skipped */
+		return 0;
+	}
+
+#ifdef PICO_CURSOR_CHECKED
+	return !cursor->malformed;
+#else
+	return 1;
+#endif
+}
+
+#endif
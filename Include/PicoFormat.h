@@ -0,0 +1,92 @@
+/*
+ * PICO Manager Library - Vault format
+ *
+ * Layout of a PICO vault, shared by the loader and the host-side tools.
+ * Plain C types only, so it builds without windows.h.
+ *
+ * A vault is a PICO_HDR, a directive stream ending in PICO_INST_COMPLETE and
+ * the resources the copy directives read from, at hdr.rsrcOffset.
+ *
+ * Compact (v2) vaults replace the directive stream with one
+ * PICO_DIRECTIVE_COMPACT followed by a byte stream:
+ *
+ *   varint size, then size bytes of NUL-terminated strings (LL/GPA arguments, deduplicated)
+ *   records, each: byte type, byte option, varint count, count items
+ *   a single PICO_INST_COMPLETE byte
+ *
+ * Record items by type:
+ *   PATCH, PATCH_DIFF, PATCH_FUNC: varint offset, as a delta from the previous item of the record
+ *   COPY:                          varint src_offset, varint dst_offset, varint total
+ *   LL, GPA:                       varint byte offset of the string in the string table
+ *   EXPORT:                        zigzag varint tag, varint offset (one item per record)
+ *
+ * Varints are unsigned LEB128. A record stands for count directives of its
+ * type and option in a row, with the same meaning as in the full format.
+ */
+
+#ifndef PICO_FORMAT_H
+#define PICO_FORMAT_H
+
+typedef struct {
+	int codeLength;
+	int dataLength;
+	int rsrcOffset;
+	int entryAddress;
+} PICO_HDR;
+
+#define FIRST_PICO_DIRECTIVE(x) (PICO_DIRECTIVE_HDR *)((void *)x + sizeof(PICO_HDR))
+#define NEXT_PICO_DIRECTIVE(x)  (PICO_DIRECTIVE_HDR *)((void *)x + x->length);
+
+#define PICO_INST_COMPLETE   0x0
+#define PICO_INST_PATCH      0x1
+#define PICO_INST_COPY       0x2
+#define PICO_INST_LL         0x3
+#define PICO_INST_GPA        0x4
+#define PICO_INST_PATCH_DIFF 0x5
+#define PICO_INST_PATCH_FUNC 0x6
+#define PICO_INST_EXPORT     0x7
+#define PICO_INST_COMPACT    0x8
+
+#define PICO_PATCH_TEXT_TEXT 0x0
+#define PICO_PATCH_TEXT_BASE 0x1
+#define PICO_PATCH_BASE_TEXT 0x2
+#define PICO_PATCH_BASE_BASE 0x3
+
+#define PICO_PATCHF_FUNC     0x0
+
+#define PICO_CONTEXT_CODE    0x5
+#define PICO_CONTEXT_DATA    0x6
+
+#define PICO_COMPACT_VERSION 0x2
+
+typedef struct {
+	char  type;
+	char  option;
+	short length;
+} PICO_DIRECTIVE_HDR;
+
+typedef struct {
+	PICO_DIRECTIVE_HDR hdr;
+	int offset;
+} PICO_DIRECTIVE_PATCH;
+
+typedef struct {
+	PICO_DIRECTIVE_HDR hdr;
+	int src_offset;
+	int dst_offset;
+	int total;
+} PICO_DIRECTIVE_COPY;
+
+typedef struct {
+	PICO_DIRECTIVE_HDR hdr;
+	int tag;
+	int offset;
+} PICO_DIRECTIVE_EXPORT;
+
+/* First and only directive of a compact vault: option is PICO_COMPACT_VERSION */
+typedef struct {
+	PICO_DIRECTIVE_HDR hdr;
+	int streamLength;
+} PICO_DIRECTIVE_COMPACT;
+
+#endif
@@ -10,16 +10,222 @@
 
 #include <windows.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define PICO_NAME_MAX_LENGTH 32
 
+/* FNV-1a parameters of PicoNameHash, shared with PicoManager.hpp */
+#define PICO_NAME_HASH_BASIS 0x811C9DC5
+#define PICO_NAME_HASH_PRIME 0x01000193
+
+/* Maximum number of entries handled by the dependency scheduler (one bit per entry) */
+#define PICO_SCHEDULE_MAX 64
+
+/* Page granularity used when releasing code ranges */
+#define PICO_PAGE_SIZE 0x1000
+
+/* Entry flags */
+#define PICO_FLAG_INIT        0x1           /* Run entry point after load, before dependents */
+#define PICO_FLAG_PINNED      0x2           /* Never evicted by the memory budget */
+#define PICO_FLAG_LOADING     0x4           /* Placed, image not complete yet (internal) */
+#define PICO_FLAG_DECOMMITTED 0x8           /* Code pages decommitted by an unload (internal) */
+#define PICO_FLAG_INITIALIZED 0x10          /* Init entry point ran for the current load (internal) */
+
+/* Dependency requirements for AddPicoDependency */
+#define PICO_DEPENDENCY_LOADED   0x0        /* Dependency must be loaded first */
+#define PICO_DEPENDENCY_EXECUTED 0x1        /* Dependency must be loaded and its entry point executed */
+
+/* Channel kinds for CreatePicoChannel */
+#define PICO_CHANNEL_SPSC 0x0               /* Single producer, single consumer */
+#define PICO_CHANNEL_MPSC 0x1               /* Multiple producers, single consumer */
+
+/* Cache line size used to keep producer and consumer state apart */
+#define PICO_CACHE_LINE 64
+
+/* CRC32C implementations, probed once per manager */
+#define PICO_CRC_UNKNOWN  0x0               /* Not probed yet */
+#define PICO_CRC_SOFTWARE 0x1               /* Byte table */
+#define PICO_CRC_HARDWARE 0x2               /* SSE4.2 crc32 instruction */
+
+/* Task states */
+#define PICO_TASK_PENDING 0x0               /* Submitted, not finished yet */
+#define PICO_TASK_DONE    0x1               /* Function returned */
+#define PICO_TASK_FAILED  0x2               /* Executor stopped before the task ran */
+
+/* activeTasks of an entry the manager is unloading, updating or removing */
+#define PICO_TASKS_CLAIMED ((LONG)0x80000000)
+
+/* Memory kinds passed to allocator callbacks */
+#define PICO_MEMORY_CODE 0x0                /* Shared RWX code block */
+#define PICO_MEMORY_DATA 0x1                /* PICO data sections */
+#define PICO_MEMORY_META 0x2                /* Manager arena and stored vaults */
+#define PICO_MEMORY_LARGE 0x100             /* Or'ed into the kind: back with large pages, committed at once */
+
+/* Code block options for PicoManagerSetBlockOptions */
+#define PICO_BLOCK_LARGE_PAGES 0x1          /* Back the code block with large pages if possible */
+#define PICO_BLOCK_PREFAULT    0x2          /* Touch every page of a PICO's code and data when it is loaded */
+#define PICO_BLOCK_DATA_ARENA  0x4          /* Give PICOs without a data slot one in a data reservation of their own */
+
+/* Most parts a parallel load is split into */
+#define PICO_LOAD_PARTS_MAX 64
+
+/* Manager operations OS and import calls are attributed to */
+#define PICO_OP_OTHER     0x0               /* Anything outside the operations below */
+#define PICO_OP_ALLOC     0x1               /* PicoManagerAlloc and DuplicateManager */
+#define PICO_OP_LOAD      0x2               /* LoadPico, LoadPicoScheduled and UsePico* reloads, evictions included */
+#define PICO_OP_UNLOAD    0x3               /* UnloadPico* */
+#define PICO_OP_REMOVE    0x4               /* RemovePico* */
+#define PICO_OP_RESET     0x5               /* ResetPico* */
+#define PICO_OP_ARENA     0x6               /* PicoManagerInitArena */
+#define PICO_OP_BOOTSTRAP 0x7               /* PicoManagerBootstrap */
+#define PICO_OP_RESTORE   0x8               /* PicoManagerRestore */
+#define PICO_OP_DESTROY   0x9               /* DestroyManager */
+#define PICO_OP_EXECUTOR  0xA               /* PicoExecutorStart */
+#define PICO_OP_UPDATE    0xB               /* UpdatePico* */
+#define PICO_OP_COUNT     12
+
+/* Calls counted for each operation */
+#define PICO_CALL_RESERVE        0x0        /* VirtualAlloc reserve, or the allocator's Reserve */
+#define PICO_CALL_COMMIT         0x1        /* VirtualAlloc commit, or the allocator's Commit */
+#define PICO_CALL_DECOMMIT       0x2        /* VirtualFree decommit, or the allocator's Decommit */
+#define PICO_CALL_RELEASE        0x3        /* VirtualFree release, or the allocator's Release */
+#define PICO_CALL_LOADLIBRARY    0x4        /* IMPORTFUNCS LoadLibraryA */
+#define PICO_CALL_GETPROCADDRESS 0x5        /* IMPORTFUNCS GetProcAddress */
+#define PICO_CALL_THREAD         0x6        /* CreateThread and CreateSemaphoreA */
+#define PICO_CALL_LOADER         0x7        /* Loader passes: PicoLoad, PicoResetData, PicoRebase */
+#define PICO_CALL_COUNT          8
+
+/* Block map region types reported by PicoManagerLayout */
+#define PICO_REGION_CODE     0x0            /* Code section of a loaded PICO */
+#define PICO_REGION_PADDING  0x1            /* Inter-PICO padding after a slot */
+#define PICO_REGION_UNLOADED 0x2            /* Slot kept for a registered PICO that is not loaded */
+#define PICO_REGION_FREE     0x3            /* Unused bytes: holes between slots and the block tail */
+
+/* Checkpoint blob identification */
+#define PICO_CHECKPOINT_MAGIC   0x504B4350  /* "PCKP" */
+#define PICO_CHECKPOINT_VERSION 2
+
+/* Offset recorded for entries that were not loaded at checkpoint time */
+#define PICO_CHECKPOINT_NOT_LOADED ((SIZE_T)-1)
+
+/* Delta blob identification */
+#define PICO_DELTA_MAGIC 0x544C4450         /* "PDLT" */
+
+/* Delta operations */
+#define PICO_DELTA_COPY 0x0                 /* Copy bytes out of the old vault */
+#define PICO_DELTA_ADD  0x1                 /* Literal bytes follow the operation, padded to 4 bytes */
+
 /* ========================================================================
  * TYPE DEFINITIONS
  * ======================================================================== */
 
+/* C++ needs the qualified names, the members would change their meaning */
+#ifdef __cplusplus
+typedef struct {
+	__typeof__(::LoadLibraryA)   * LoadLibraryA;
+	__typeof__(::GetProcAddress) * GetProcAddress;
+} IMPORTFUNCS;
+#else
 typedef struct {
 	__typeof__(LoadLibraryA)   * LoadLibraryA;
 	__typeof__(GetProcAddress) * GetProcAddress;
 } IMPORTFUNCS;
+#endif
+
+/*
+ * Allocator callbacks
+ * Replace the VirtualAlloc/VirtualFree calls the library makes. The code
+ * block is committed read-write-execute once and never changes protection,
+ * so there is no protect callback.
+ * Committed memory must read as zero, like fresh VirtualAlloc pages.
+ * A Reserve kind or'ed with PICO_MEMORY_LARGE asks for large pages; return
+ * NULL to have the library retry with normal pages.
+ */
+typedef struct _PICO_ALLOCATOR {
+    LPVOID (*Reserve)(LPVOID context, SIZE_T size, DWORD protect, DWORD kind);          /* Reserve, and commit with protect unless it is 0 */
+    BOOL (*Commit)(LPVOID context, LPVOID address, SIZE_T size, DWORD protect, DWORD kind);
+    BOOL (*Decommit)(LPVOID context, LPVOID address, SIZE_T size, DWORD kind);
+    BOOL (*Release)(LPVOID context, LPVOID address, SIZE_T size, DWORD kind);           /* Whole region, size as reserved */
+    LPVOID context;                         /* Passed to every callback */
+} PICO_ALLOCATOR, *PPICO_ALLOCATOR;
+
+/*
+ * OS and import call statistics of a manager
+ * Counting is always on. Time is measured with the time stamp counter only
+ * while timing is set; import calls are made from inside the loader, so
+ * their time is part of the PICO_CALL_LOADER ticks.
+ */
+typedef struct _PICO_STATS {
+    DWORD operation;                        /* PICO_OP_* the calls are currently attributed to (PICO_OP_OTHER between operations) */
+    BOOL timing;                            /* Accumulate ticks as well as counts */
+    DWORD64 calls[PICO_OP_COUNT][PICO_CALL_COUNT];  /* Number of calls */
+    DWORD64 ticks[PICO_OP_COUNT][PICO_CALL_COUNT];  /* Time stamp counter ticks spent in them */
+} PICO_STATS, *PPICO_STATS;
+
+/*
+ * Block map region
+ * One contiguous range of the code block. Slots of registered PICOs are
+ * reported even where they would not fit in the block, so offset + size
+ * may exceed blockSize.
+ */
+typedef struct _PICO_LAYOUT_REGION {
+    DWORD type;                             /* PICO_REGION_* value */
+    DWORD id;                               /* Entry ID for code and unloaded slots (0 otherwise) */
+    DWORD flags;                            /* Entry PICO_FLAG_* values for code and unloaded slots */
+    SIZE_T offset;                          /* Offset from the start of the code block */
+    SIZE_T size;                            /* Size of the region in bytes */
+    char* data;                             /* Data section of a loaded PICO (NULL otherwise) */
+    SIZE_T dataSize;                        /* Size of its data section */
+} PICO_LAYOUT_REGION, *PPICO_LAYOUT_REGION;
+
+/*
+ * Block layout summary filled by PicoManagerLayout
+ */
+typedef struct _PICO_LAYOUT {
+    char* baseAddress;                      /* Base address of the code block (NULL if not allocated) */
+    SIZE_T blockSize;                       /* Total size of the code block */
+    SIZE_T usedSize;                        /* Manager's used size */
+    SIZE_T interPicoPadding;                /* Padding after each slot */
+    SIZE_T requiredSize;                    /* Bytes the slots of all registered PICOs need, padding included */
+    SIZE_T freeSize;                        /* Bytes of the block holding neither loaded code nor padding */
+    SIZE_T largestFree;                     /* Largest contiguous run of such bytes */
+    SIZE_T paddingSize;                     /* Bytes of the block taken by inter-PICO padding */
+    SIZE_T residentData;                    /* Data bytes of loaded PICOs */
+    DWORD regionCount;                      /* Regions in the block map */
+} PICO_LAYOUT, *PPICO_LAYOUT;
+
+/*
+ * Export index record of a cached vault
+ */
+typedef struct _PICO_VAULT_EXPORT {
+    int tag;                                /* Export tag identifier */
+    int offset;                             /* Offset of the export in the code section */
+} PICO_VAULT_EXPORT, *PPICO_VAULT_EXPORT;
+
+/*
+ * Vault cache slot
+ * Everything parsed out of one distinct vault content, shared by every entry
+ * (in any manager using the cache) that registers a vault with that content.
+ */
+typedef struct _PICO_VAULT_INFO {
+    DWORD64 key;                            /* Fingerprint of the vault header, the hash key (0 if slot is free) */
+    DWORD64 fingerprint;                    /* Fingerprint of the whole vault, taken when the slot is filled */
+    char* vault;                            /* Stored copy, or first buffer registered with this content (NULL if released) */
+    struct _PICO_VAULT_CACHE* cache;        /* Cache the slot belongs to */
+    DWORD references;                       /* Entries and callers holding the slot */
+    BOOL owned;                             /* TRUE if the cache allocated vault and frees it */
+    SIZE_T storedSize;                      /* Size of the cache's allocation (0 if not owned) */
+    DWORD vaultSize;                        /* Size of the vault in bytes */
+    DWORD codeSize;                         /* Size of code section */
+    DWORD dataSize;                         /* Size of data section */
+    DWORD importCount;                      /* Number of imported functions */
+    DWORD libraryCount;                     /* LoadLibraryA calls per load */
+    DWORD procedureCount;                   /* GetProcAddress calls per load */
+    PPICO_VAULT_EXPORT exports;             /* Export index (NULL if it did not fit) */
+    DWORD exportCount;                      /* Number of records in the export index */
+} PICO_VAULT_INFO, *PPICO_VAULT_INFO;
 
 /*
  * Individual PICO module entry
@@ -28,14 +234,182 @@ typedef struct {
 typedef struct _PICO_ENTRY {
     DWORD id;                               /* Unique identifier */
     char name[PICO_NAME_MAX_LENGTH];        /* Module name for lookup */
+    DWORD nameHash;                         /* PicoNameHash of name, compared before the name */
     char* code;                             /* Pointer to code section in shared RWX block */
     SIZE_T codeSize;                        /* Size of code section */
     char* data;                             /* Pointer to data section in separate RW block */
     SIZE_T dataSize;                        /* Size of data section */
     char* entryPoint;                       /* Module entry point function */
     char* vault;                            /* Pointer to original PICO buffer (read-only reference) */
+    DWORD64 dependencies;                   /* Bitmask of entry IDs that must be loaded first */
+    DWORD flags;                            /* PICO_FLAG_* values */
+    volatile LONG activeTasks;              /* Executor tasks currently queued or running its code (PICO_TASKS_CLAIMED while claimed) */
+    DWORD64 lastUse;                        /* Manager use clock value at last load or use */
+    ULONG_PTR* imports;                     /* Resolved import cache for data resets (NULL if none) */
+    PPICO_VAULT_INFO info;                  /* Shared vault cache slot (NULL if none) */
+    DWORD codeCrc;                          /* CRC32C of the code section recorded at load */
+    char* dataSlot;                         /* Data section storage kept across loads: co-located, arena or bootstrap (NULL if allocated per load) */
 } PICO_ENTRY, *PPICO_ENTRY;
 
+/*
+ * Export registry slot
+ * Maps one export tag of a loaded PICO to its resolved address
+ */
+typedef struct _PICO_EXPORT_SLOT {
+    PPICO_ENTRY entry;                      /* Module providing the export (NULL if slot is free) */
+    char* address;                          /* Resolved export address */
+    int tag;                                /* Export tag identifier */
+} PICO_EXPORT_SLOT, *PPICO_EXPORT_SLOT;
+
+/*
+ * Bound export slot
+ * Export of a fixed module, kept current by the manager as the module is
+ * loaded, unloaded and updated, so reading it is a single indexed load.
+ */
+typedef struct _PICO_BOUND_EXPORT {
+    DWORD id;                               /* Entry ID of the providing module */
+    int tag;                                /* Export tag identifier */
+    char* address;                          /* Resolved export address (NULL while not loaded) */
+} PICO_BOUND_EXPORT, *PPICO_BOUND_EXPORT;
+
+/*
+ * Bounded ring channel between PICO modules
+ * Allocated from the manager arena and looked up by name.
+ * Producer and consumer positions live on separate cache lines.
+ */
+typedef struct _PICO_CHANNEL {
+    char name[PICO_NAME_MAX_LENGTH];        /* Channel name for lookup */
+    struct _PICO_CHANNEL* next;             /* Next channel owned by the manager */
+    DWORD kind;                             /* PICO_CHANNEL_SPSC or PICO_CHANNEL_MPSC */
+    DWORD itemSize;                         /* Size of one item in bytes */
+    DWORD capacity;                         /* Number of item slots (power of two) */
+    char* items;                            /* Item storage (capacity * itemSize bytes) */
+    volatile LONG* sequence;                /* Per-slot publish sequence (MPSC only) */
+    char padding0[PICO_CACHE_LINE];
+    volatile LONG head;                     /* Consumer position */
+    char padding1[PICO_CACHE_LINE - sizeof(LONG)];
+    volatile LONG tail;                     /* Producer position */
+    char padding2[PICO_CACHE_LINE - sizeof(LONG)];
+} PICO_CHANNEL, *PPICO_CHANNEL;
+
+/*
+ * Executor task
+ * Caller-owned description of one call into a loaded PICO.
+ */
+typedef struct _PICO_TASK {
+    PPICO_ENTRY entry;                      /* Module whose code the task runs (NULL for a function outside any module) */
+    char* function;                         /* Function to call (NULL for the module entry point) */
+    char* arg;                              /* Argument passed to the function */
+    volatile LONG state;                    /* PICO_TASK_PENDING, PICO_TASK_DONE or PICO_TASK_FAILED */
+} PICO_TASK, *PPICO_TASK;
+
+/*
+ * Executor worker
+ * One thread with its own task deque (owner works the bottom, thieves the top)
+ * and an MPSC inbox channel for tasks submitted from outside the pool.
+ */
+typedef struct _PICO_WORKER {
+    HANDLE thread;                          /* Worker thread handle */
+    DWORD threadId;                         /* Worker thread ID */
+    struct _PICO_EXECUTOR* executor;        /* Owning executor */
+    PPICO_CHANNEL inbox;                    /* Tasks submitted by non-worker threads */
+    PPICO_TASK* deque;                      /* Work-stealing deque slots */
+    DWORD dequeCapacity;                    /* Number of deque slots (power of two) */
+    char padding0[PICO_CACHE_LINE];
+    volatile LONG top;                      /* Steal end of the deque */
+    char padding1[PICO_CACHE_LINE - sizeof(LONG)];
+    volatile LONG bottom;                   /* Owner end of the deque */
+    char padding2[PICO_CACHE_LINE - sizeof(LONG)];
+} PICO_WORKER, *PPICO_WORKER;
+
+/*
+ * Work-stealing executor owned by a manager
+ */
+typedef struct _PICO_EXECUTOR {
+    PPICO_WORKER workers;                   /* Array of workers */
+    DWORD workerCount;                      /* Number of workers */
+    DWORD workerCapacity;                   /* Workers and deques allocated by the first start */
+    DWORD taskCapacity;                     /* Deque slots allocated per worker by the first start */
+    HANDLE wakeup;                          /* Semaphore released once per submitted task */
+    volatile LONG stopping;                 /* Set when workers should exit */
+    volatile LONG submitting;               /* Submissions in progress, waited out by a stop */
+    volatile LONG nextWorker;               /* Round-robin cursor for inbox submission */
+} PICO_EXECUTOR, *PPICO_EXECUTOR;
+
+/*
+ * Vault cache
+ * Caller-owned hash table of vault information keyed by a fingerprint of
+ * the vault header; content is matched on size and a fingerprint of the
+ * whole vault. Several managers may share one cache.
+ */
+typedef struct _PICO_VAULT_CACHE {
+    PPICO_VAULT_INFO slots;                 /* Hash table slots */
+    DWORD slotCapacity;                     /* Number of slots (power of two) */
+    DWORD slotCount;                        /* Number of used slots, released ones included */
+    DWORD liveCount;                        /* Number of slots holding a vault */
+    PPICO_VAULT_EXPORT exports;             /* Storage for export indexes */
+    DWORD exportCapacity;                   /* Number of export records available */
+    DWORD exportUsed;                       /* Export records in use or in free runs, from the start */
+    DWORD exportFree;                       /* First free run of released export records (0xFFFFFFFF if none) */
+    volatile LONG lock;                     /* Held while the cache is modified */
+    PPICO_ALLOCATOR allocator;              /* Allocator for stored vaults (NULL for VirtualAlloc) */
+} PICO_VAULT_CACHE, *PPICO_VAULT_CACHE;
+
+/*
+ * Checkpoint blob header
+ * Followed by one PICO_CHECKPOINT_ENTRY record per entry. Every record is
+ * followed by the entry's vault and, if it was loaded, its code and data
+ * images as they were in memory. All parts are 16-byte aligned.
+ */
+typedef struct _PICO_CHECKPOINT_HDR {
+    DWORD magic;                            /* PICO_CHECKPOINT_MAGIC */
+    DWORD version;                          /* PICO_CHECKPOINT_VERSION */
+    DWORD pointerSize;                      /* sizeof(ULONG_PTR) of the writer */
+    DWORD entryCount;                       /* Number of entry records */
+    DWORD crc;                              /* CRC32C of the whole blob, computed with this field 0 */
+    SIZE_T totalSize;                       /* Size of the whole blob in bytes */
+    SIZE_T blockSize;                       /* Size of the RWX block */
+    SIZE_T usedSize;                        /* Used size of the RWX block */
+    SIZE_T interPicoPadding;                /* Padding between PICOs */
+    ULONG_PTR oldBase;                      /* RWX block address the images were captured at */
+} PICO_CHECKPOINT_HDR, *PPICO_CHECKPOINT_HDR;
+
+/*
+ * Checkpoint entry record
+ */
+typedef struct _PICO_CHECKPOINT_ENTRY {
+    char name[PICO_NAME_MAX_LENGTH];        /* Module name */
+    DWORD64 dependencies;                   /* Dependency bitmask */
+    DWORD flags;                            /* PICO_FLAG_INIT, PICO_FLAG_PINNED and PICO_FLAG_INITIALIZED */
+    DWORD vaultSize;                        /* Size of the vault copy that follows */
+    SIZE_T codeOffset;                      /* Offset in the RWX block, or PICO_CHECKPOINT_NOT_LOADED */
+    SIZE_T codeSize;                        /* Size of the code image */
+    SIZE_T dataSize;                        /* Size of the data image */
+    ULONG_PTR oldData;                      /* Data section address the image was captured at */
+} PICO_CHECKPOINT_ENTRY, *PPICO_CHECKPOINT_ENTRY;
+
+/*
+ * Delta blob header
+ * Followed by PICO_DELTA_OP records that, in order, produce the new vault.
+ */
+typedef struct _PICO_DELTA_HDR {
+    DWORD magic;                            /* PICO_DELTA_MAGIC */
+    DWORD oldSize;                          /* Bytes of the old vault the delta was made against */
+    DWORD oldCrc;                           /* CRC32C of those bytes */
+    DWORD newSize;                          /* Size of the new vault */
+    DWORD newCrc;                           /* CRC32C of the new vault */
+    DWORD deltaSize;                        /* Size of the whole delta, header included */
+} PICO_DELTA_HDR, *PPICO_DELTA_HDR;
+
+/*
+ * Delta operation
+ */
+typedef struct _PICO_DELTA_OP {
+    DWORD type;                             /* PICO_DELTA_COPY or PICO_DELTA_ADD */
+    DWORD offset;                           /* Offset in the old vault (copies only) */
+    DWORD length;                           /* Number of bytes produced */
+} PICO_DELTA_OP, *PPICO_DELTA_OP;
+
 /*
  * PICO Manager structure
  * Tracks all loaded PICO modules and manages the shared RWX memory block
@@ -43,11 +417,49 @@ typedef struct _PICO_ENTRY {
 typedef struct _PICO_MANAGER {
     char* baseAddress;                      /* Base address of shared RWX memory block */
     SIZE_T blockSize;                       /* Total size of RWX memory block */
+    SIZE_T reserveSize;                     /* Size of the reservation holding the block, co-located data slots included */
     SIZE_T usedSize;                        /* Currently used size in bytes */
     PPICO_ENTRY entries;                    /* Array of PICO entries */
     DWORD entryCount;                       /* Number of registered PICOs */
     DWORD entryCapacity;                    /* Maximum capacity of entries array */
     SIZE_T interPicoPadding;                /* Padding between PICOs in bytes */
+    PPICO_EXPORT_SLOT exportSlots;          /* Export registry hash table (NULL if disabled) */
+    DWORD exportCapacity;                   /* Number of slots in the export registry (power of two) */
+    DWORD exportCount;                      /* Number of occupied export registry slots */
+    BOOL exportOverflow;                    /* TRUE if an export did not fit in the registry */
+    DWORD* nameSlots;                       /* Name index hash table: entry ID + 1, 0 if free (NULL if disabled) */
+    DWORD nameCapacity;                     /* Number of slots in the name index (power of two) */
+    PPICO_BOUND_EXPORT boundExports;        /* Bound export slots (NULL if none) */
+    DWORD boundCount;                       /* Number of bound export slots */
+    char* arenaBase;                        /* Base address of the manager arena (NULL if none) */
+    SIZE_T arenaSize;                       /* Total size of the manager arena */
+    SIZE_T arenaUsed;                       /* Bytes handed out from the manager arena */
+    PPICO_CHANNEL channels;                 /* Channels allocated from the arena */
+    PPICO_EXECUTOR executor;                /* Running executor (NULL if none) */
+    PPICO_EXECUTOR executorState;           /* Executor state kept in the arena across restarts (NULL before the first start) */
+    char* dataArenaBase;                    /* Data slot reservation for PICO_BLOCK_DATA_ARENA (NULL until needed) */
+    SIZE_T dataArenaSize;                   /* Size of the data arena reservation */
+    SIZE_T dataArenaUsed;                   /* Bytes of the data arena handed out as slots */
+    SIZE_T codeBudget;                      /* Maximum resident code bytes (0 for no limit) */
+    SIZE_T dataBudget;                      /* Maximum resident data bytes (0 for no limit) */
+    SIZE_T residentCode;                    /* Code bytes of currently loaded PICOs (not committed memory on large pages) */
+    SIZE_T residentData;                    /* Data bytes of currently loaded PICOs */
+    DWORD64 useClock;                       /* Ticks on every load and use, orders PICOs for eviction */
+    IMPORTFUNCS * funcs;                    /* Import functions remembered for reloading evicted PICOs */
+    SIZE_T finalPadding;                    /* Final padding of the last LoadPico or LoadPicoScheduled, kept free by later placements */
+    PPICO_VAULT_CACHE vaultCache;           /* Shared vault cache (NULL if none) */
+    DWORD verifyEntry;                      /* Integrity scan cursor: entry ID */
+    SIZE_T verifyOffset;                    /* Integrity scan cursor: offset in its code section */
+    DWORD verifyCrc;                        /* Integrity scan cursor: CRC32C of the code before the offset */
+    DWORD crcSupport;                       /* PICO_CRC_* implementation the manager checksums with */
+    PPICO_ALLOCATOR allocator;              /* Allocator for all manager memory (NULL for VirtualAlloc) */
+    char* bootstrapBase;                    /* Single reservation holding all manager memory (NULL if not bootstrapped) */
+    SIZE_T bootstrapSize;                   /* Size of the bootstrap reservation */
+    PICO_STATS stats;                       /* OS and import call statistics */
+    DWORD blockOptions;                     /* PICO_BLOCK_* values */
+    SIZE_T largePageSize;                   /* Large page size backing the code block (0 for normal pages) */
+    DWORD loadParts;                        /* Parts a big PICO's load is split into (0 or 1: not split) */
+    SIZE_T loadThreshold;                   /* Copy bytes from which a PICO's load is split */
 } PICO_MANAGER, *PPICO_MANAGER;
 
 /* ========================================================================
@@ -89,6 +501,10 @@ BOOL AddPico(
  * Allocates the shared RWX memory block for storing PICO code sections.
  * Must be called after adding all initial PICOs or before each load phase.
  * Calculates required size based on registered PICOs and desired padding.
+ * Registered PICOs get their data slots in the same reservation, right after
+ * the block, so on x64 data is always within rel32 reach of the code. Each
+ * slot is whole pages of its own, committed on load and decommitted on
+ * unload. With large pages there are no slots: data is allocated per load.
  *
  * @param manager        - Pointer to the PICO_MANAGER structure
  * @param finalPadding   - Additional padding in bytes to reserve at end of block
@@ -102,7 +518,8 @@ BOOL PicoManagerAlloc(
 /*
  * Loads all registered but not yet loaded PICOs into the manager's RWX block.
  * Places PICO code sections sequentially in the block with padding.
- * Allocates separate RW blocks for each PICO's data section.
+ * Uses each PICO's data slot, or allocates a separate RW block for its data
+ * section (a data arena slot with PICO_BLOCK_DATA_ARENA).
  *
  * @param manager      - Pointer to the PICO_MANAGER structure
  * @param upToEntryId  - Load only entries up to and including this ID (or -1 for all)
@@ -110,6 +527,9 @@ BOOL PicoManagerAlloc(
  * @param funcs        - Import functions structure for loading
  * @return TRUE on success, FALSE if not enough space or loading failure
  *
+ * Note: On x64 a data section allocated further than 2GB from its code is
+ * released again and the load fails.
+ *
  * This function can be called multiple times to load more PICOs in phases,
  * as long as the block was allocated with sufficient size.
  * Example: LoadPico(mgr, 0, 10, funcs) - loads only entry 0 (hooks)
@@ -122,6 +542,177 @@ BOOL LoadPico(
     IMPORTFUNCS * funcs
 );
 
+/*
+ * Declares that a PICO depends on another registered PICO.
+ * Used by LoadPicoScheduled to order loading.
+ *
+ * @param manager     - Pointer to the PICO_MANAGER structure
+ * @param name        - Name of the dependent PICO
+ * @param dependency  - Name of the PICO it depends on
+ * @param requirement - PICO_DEPENDENCY_LOADED or PICO_DEPENDENCY_EXECUTED
+ * @return TRUE on success, FALSE if a name is not found, both names are equal
+ *         or the dependency ID is beyond PICO_SCHEDULE_MAX
+ *
+ * Example: AddPicoDependency(mgr, "commands", "hooks", PICO_DEPENDENCY_EXECUTED)
+ */
+BOOL AddPicoDependency(
+    PPICO_MANAGER manager,
+    const char* name,
+    const char* dependency,
+    DWORD requirement
+);
+
+/*
+ * Loads all registered but not yet loaded PICOs in dependency order.
+ * Builds levels from the declared dependencies and loads each level in parallel,
+ * on the executor's workers when it is started and one thread per PICO otherwise.
+ * Entry points of PICOs flagged PICO_FLAG_INIT run (with initArg) before the
+ * next level is loaded, so import hooks are in place for their dependents.
+ * They run once per load: PICO_FLAG_INITIALIZED records it until the PICO is
+ * unloaded, and an init PICO another call already loaded runs its entry
+ * point here before its dependents count it as done.
+ * Dependencies of pending PICOs are pinned while the call runs, so the
+ * memory budget cannot evict them to make room for their dependents.
+ * Uses the same block layout as LoadPico.
+ * On failure, levels loaded before stay loaded; the PICOs of the level that
+ * could not be placed are left registered and unloaded.
+ *
+ * @param manager      - Pointer to the PICO_MANAGER structure
+ * @param finalPadding - Additional padding in bytes to reserve at the end
+ * @param funcs        - Import functions structure for loading
+ * @param initArg      - Argument passed to init entry points
+ * @return TRUE on success, FALSE if not enough space, allocation failure,
+ *         a dependency cycle, or more than PICO_SCHEDULE_MAX entries
+ *
+ * Example: LoadPicoScheduled(mgr, 100, &funcs, (char*)&funcs)
+ */
+BOOL LoadPicoScheduled(
+    PPICO_MANAGER manager,
+    SIZE_T finalPadding,
+    IMPORTFUNCS * funcs,
+    char* initArg
+);
+
+/*
+ * Configures budget mode: resident code and data of loaded PICOs are kept
+ * within the given limits by unloading the least recently used PICOs.
+ * Evicted PICOs keep their registration and vault and are loaded again
+ * on their next UsePicoById/UsePicoByName. Their data section starts over
+ * from its initial state.
+ *
+ * @param manager     - Pointer to the PICO_MANAGER structure
+ * @param codeBudget  - Maximum resident code bytes (0 for no limit)
+ * @param dataBudget  - Maximum resident data bytes (0 for no limit)
+ * @param funcs       - Import functions used for reloads (NULL keeps the ones
+ *                      remembered from the last LoadPico)
+ * @return TRUE on success, FALSE on invalid arguments
+ *
+ * Note: Pinned (PICO_FLAG_PINNED) and init (PICO_FLAG_INIT) PICOs and PICOs
+ * with active executor tasks are never evicted. A load fails if the budget
+ * cannot be met by evicting the others. A code block on large pages
+ * (PICO_BLOCK_LARGE_PAGES) is committed whole and unloading does not
+ * decommit it, so there the code budget is not enforced and only the data
+ * budget evicts.
+ */
+BOOL PicoManagerSetBudget(
+    PPICO_MANAGER manager,
+    SIZE_T codeBudget,
+    SIZE_T dataBudget,
+    IMPORTFUNCS * funcs
+);
+
+/*
+ * Sets how the code block is backed and warmed up. Must be called before
+ * the block is allocated.
+ * PICO_BLOCK_LARGE_PAGES backs the block allocated by PicoManagerAlloc or
+ * PicoManagerRestore with large pages (size rounded up to the large page
+ * size), falling back to normal pages when they cannot be had.
+ * PICO_BLOCK_PREFAULT touches every page of a PICO's code and data right
+ * after it is loaded, so its first call does not fault.
+ * PICO_BLOCK_DATA_ARENA gives each PICO without a data slot one in the data
+ * arena on its first load, kept for later loads, so PicoManagerTeardown
+ * releases all data with one call. The data arena is a reservation of its
+ * own, apart from the metadata arena, made on the first load that needs it
+ * with whole pages for every registered PICO lacking a slot; slots are
+ * committed on load and decommitted on unload. PICOs registered after that,
+ * or placed out of rel32 reach of it, get data sections one by one as usual.
+ * Slots co-located by PicoManagerAlloc come first.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param options - PICO_BLOCK_* values
+ * @return TRUE on success, FALSE if the code block already exists
+ *
+ * Note: Large pages need SeLockMemoryPrivilege enabled in the process token.
+ * manager->largePageSize tells whether they were used. Large pages cannot be
+ * decommitted, so unloads keep their code pages. PicoManagerBootstrap keeps
+ * normal pages, its reservation is committed with mixed protections.
+ */
+BOOL PicoManagerSetBlockOptions(
+    PPICO_MANAGER manager,
+    DWORD options
+);
+
+/*
+ * Touches every page of the code and data sections of all loaded PICOs,
+ * bringing them back into the working set before they are called, e.g.
+ * after the working set was trimmed during a sleep.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @return TRUE on success, FALSE on invalid arguments
+ */
+BOOL PicoManagerPrefault(
+    PPICO_MANAGER manager
+);
+
+/*
+ * Splits the load of big PICOs across the executor workers. A PICO whose
+ * copy directives move at least threshold bytes is loaded in parts: copies,
+ * then patches, each phase shared by parts threads, then imports on the
+ * calling thread. The directive stream is cut into parts in one walk.
+ *
+ * @param manager   - Pointer to the PICO_MANAGER structure
+ * @param parts     - Threads sharing each phase, calling thread included (0 or 1 to turn off)
+ * @param threshold - Copy bytes from which a PICO's load is split
+ * @return TRUE on success, FALSE if parts exceeds PICO_LOAD_PARTS_MAX
+ *
+ * Note: Parts run on the executor; without a started executor every PICO is
+ * loaded whole. So is a PICO with a PATCH, PATCH_DIFF or PATCH_FUNC ahead of
+ * a COPY, where copying first would not give what PicoLoad gives.
+ * LoadPicoScheduled keeps loading whole PICOs per task or thread, it already
+ * runs a level in parallel.
+ */
+BOOL PicoManagerSetParallelLoad(
+    PPICO_MANAGER manager,
+    DWORD parts,
+    SIZE_T threshold
+);
+
+/*
+ * Retrieves a PICO entry by ID for use, loading it again if it was evicted.
+ * Also refreshes its position in the eviction order. A reload keeps the
+ * final padding of the last load free.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param id      - Numeric ID of the PICO entry
+ * @return Pointer to the loaded PICO_ENTRY, or NULL if not found or it could not be loaded
+ */
+PPICO_ENTRY UsePicoById(
+    PPICO_MANAGER manager,
+    DWORD id
+);
+
+/*
+ * Retrieves a PICO entry by name for use, loading it again if it was evicted.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param name    - Name of the PICO module (null-terminated string)
+ * @return Pointer to the loaded PICO_ENTRY, or NULL if not found or it could not be loaded
+ */
+PPICO_ENTRY UsePicoByName(
+    PPICO_MANAGER manager,
+    const char* name
+);
+
 /*
  * Removes a PICO entry from the manager by its numeric ID.
  * Frees allocated memory and compacts the array.
@@ -130,7 +721,8 @@ BOOL LoadPico(
  *
  * @param manager - Pointer to the PICO_MANAGER structure
  * @param id      - ID of the PICO entry to remove
- * @return TRUE on success, FALSE if ID is invalid
+ * @return TRUE on success, FALSE if ID is invalid, export slots are bound or
+ *         executor tasks still reference this entry or one that would shift
  *
  * Example: [A(id=0), B(id=1), C(id=2)] -> RemovePicoById(mgr, 1) -> [A(id=0), C(id=1)]
  */
@@ -156,6 +748,159 @@ BOOL RemovePicoByName(
     const char* name
 );
 
+/*
+ * Unloads a PICO by its numeric ID without unregistering it.
+ * Decommits the code pages only this PICO occupies, frees its data section
+ * and clears code, data and entryPoint. The entry keeps its ID, name, vault
+ * and block position, and no other entry is renumbered.
+ * A later LoadPico (or UsePicoById) loads it again in the same place.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param id      - ID of the PICO entry to unload
+ * @return TRUE on success, FALSE if ID is invalid, the PICO is not loaded
+ *         or executor tasks are running its code
+ */
+BOOL UnloadPicoById(
+    PPICO_MANAGER manager,
+    DWORD id
+);
+
+/*
+ * Unloads a PICO by its name without unregistering it.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param name    - Name of the PICO entry to unload
+ * @return TRUE on success, FALSE if name is not found, the PICO is not loaded
+ *         or executor tasks are running its code
+ */
+BOOL UnloadPicoByName(
+    PPICO_MANAGER manager,
+    const char* name
+);
+
+/*
+ * Resets the data section of a loaded PICO to its freshly loaded state
+ * without touching its code or resolving imports again.
+ * Replays only the data side of the load: zero fill, data-targeted copies,
+ * BASE_* patches and the function table from the imports captured at load
+ * time (when the manager has an arena). Without a cache, imports are
+ * resolved again with the remembered import functions.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param id      - ID of the PICO entry to reset
+ * @return TRUE on success, FALSE if ID is invalid, the PICO is not loaded,
+ *         executor tasks are running its code or imports cannot be restored
+ */
+BOOL ResetPicoById(
+    PPICO_MANAGER manager,
+    DWORD id
+);
+
+/*
+ * Resets the data section of a loaded PICO by name.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param name    - Name of the PICO entry to reset
+ * @return TRUE on success, FALSE if name is not found or the reset failed
+ */
+BOOL ResetPicoByName(
+    PPICO_MANAGER manager,
+    const char* name
+);
+
+/*
+ * Replaces the vault of a registered PICO, e.g. with one rebuilt by
+ * PicoDeltaApply. If the PICO is loaded, its code size is unchanged and the
+ * new vault builds the very same data section (same data bytes, patches and
+ * imports), only the code is rebuilt in place: the live data section,
+ * resolved function table and import cache are kept. Otherwise a loaded
+ * PICO is unloaded and loaded again from the new vault at its position.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param id      - ID of the PICO to update
+ * @param vault   - New PICO buffer (must stay valid like any registered vault)
+ * @return TRUE on success, FALSE if the entry is not found, executor tasks
+ *         are running its code, the code size changes while a later PICO is
+ *         loaded, the new code does not fit the block, or a reload failed
+ *
+ * Note: The new code must fit with the padding LoadPico keeps: the
+ * inter-PICO padding and the last load's final padding after it.
+ * Entry points are not run again. The updated PICO's exports are
+ * published after those of other modules. The caller keeps ownership of
+ * the old vault.
+ * On failure the entry keeps its old vault and the new one is not
+ * referenced. If the new image could not be placed after the PICO was
+ * unloaded, the PICO is loaded again from the old vault with a fresh data
+ * section, or left unloaded if that fails as well.
+ */
+BOOL UpdatePicoById(
+    PPICO_MANAGER manager,
+    DWORD id,
+    char* vault
+);
+
+/*
+ * Replaces the vault of a registered PICO by name.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param name    - Name of the PICO to update
+ * @param vault   - New PICO buffer
+ * @return TRUE on success, FALSE if the name is not found or the update failed
+ */
+BOOL UpdatePicoByName(
+    PPICO_MANAGER manager,
+    const char* name,
+    char* vault
+);
+
+/*
+ * Encodes a delta that turns oldVault into newVault: copies out of the old
+ * vault for everything that is still there and literal bytes for the rest.
+ *
+ * @param oldVault      - Vault the delta will be applied to
+ * @param oldSize       - Size of the old vault (PicoVaultSize)
+ * @param newVault      - Vault the delta produces
+ * @param newSize       - Size of the new vault
+ * @param delta         - Output buffer
+ * @param deltaCapacity - Size of the output buffer in bytes
+ * @param table         - Scratch hash table
+ * @param tableCapacity - Number of DWORDs in the table (power of two, about oldSize)
+ * @return Size of the delta in bytes, 0 if it did not fit or arguments are invalid
+ */
+DWORD PicoDeltaCreate(
+    char* oldVault,
+    DWORD oldSize,
+    char* newVault,
+    DWORD newSize,
+    char* delta,
+    DWORD deltaCapacity,
+    DWORD* table,
+    DWORD tableCapacity
+);
+
+/*
+ * Rebuilds the new vault from the old one and a delta.
+ * The new vault is ((PPICO_DELTA_HDR)delta)->newSize bytes long.
+ *
+ * @param oldVault    - Vault the delta was made against
+ * @param oldSize     - Size of the old vault in bytes
+ * @param delta       - Delta blob
+ * @param deltaSize   - Size of the delta blob in bytes
+ * @param newVault    - Output buffer for the new vault
+ * @param newCapacity - Size of the output buffer in bytes
+ * @return TRUE on success, FALSE if the delta is malformed, its header
+ *         disagrees with oldSize or deltaSize, the output does not fit, or
+ *         either CRC32C does not match
+ */
+BOOL PicoDeltaApply(
+    char* oldVault,
+    DWORD oldSize,
+    char* delta,
+    DWORD deltaSize,
+    char* newVault,
+    DWORD newCapacity
+);
+
 /*
  * Retrieves a PICO entry by its numeric ID.
  *
@@ -181,6 +926,56 @@ PPICO_ENTRY GetPicoByName(
     const char* name
 );
 
+/*
+ * Retrieves a PICO entry by the hash of its name.
+ * Only entries whose stored hash matches have their name compared.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param hash    - PicoNameHash of the name
+ * @param name    - Name of the PICO module (null-terminated string)
+ * @return Pointer to PICO_ENTRY, or NULL if not found
+ *
+ * Note: Lets callers hash names once, or at compile time (PicoManager.hpp).
+ * With the name index enabled this is one probe sequence and a compare of
+ * the matching name; otherwise the entries are scanned.
+ */
+PPICO_ENTRY GetPicoByHash(
+    PPICO_MANAGER manager,
+    DWORD hash,
+    const char* name
+);
+
+/*
+ * FNV-1a hash of a module name, as stored in PICO_ENTRY.nameHash.
+ * Only the first PICO_NAME_MAX_LENGTH - 1 characters count, like the stored name.
+ *
+ * @param name - Name of the PICO module (null-terminated string)
+ * @return Hash of the name
+ */
+DWORD PicoNameHash(
+    const char* name
+);
+
+/*
+ * Enables the name index.
+ * Every registered PICO is indexed by its name hash in the given hash table,
+ * so GetPicoByName and GetPicoByHash do not scan the entries.
+ * Already registered PICOs are indexed immediately; AddPico and removal keep
+ * the index up to date afterwards.
+ *
+ * @param manager       - Pointer to the PICO_MANAGER structure
+ * @param slots         - Pointer to the array of slots
+ * @param slotCapacity  - Number of slots in the array (a power of two, above the entry capacity)
+ * @return TRUE on success, FALSE if arguments are invalid
+ *
+ * Note: Twice the entry capacity keeps the table at most half full.
+ */
+BOOL PicoManagerInitNames(
+    PPICO_MANAGER manager,
+    DWORD* slots,
+    DWORD slotCapacity
+);
+
 /*
  * Retrieves an export from a PICO module by ID.
  * Uses PicoGetExport from LibTcg to find the export.
@@ -211,6 +1006,533 @@ char* GetPicoExportByName(
     int tag
 );
 
+/*
+ * Enables the manager-wide export registry.
+ * Every export of every loaded PICO is indexed by tag in the given hash table,
+ * so capability lookups do not depend on module position or count.
+ * Already loaded PICOs are indexed immediately; LoadPico and removal keep the
+ * registry up to date afterwards.
+ *
+ * @param manager       - Pointer to the PICO_MANAGER structure
+ * @param slots         - Pointer to the array of PICO_EXPORT_SLOT structures
+ * @param slotCapacity  - Number of slots in the array (must be a power of two)
+ * @return TRUE on success, FALSE if arguments are invalid
+ *
+ * Note: Keep the table at most half full for short probe sequences. If an export
+ * does not fit, lookups fall back to scanning the loaded modules.
+ */
+BOOL PicoManagerInitExports(
+    PPICO_MANAGER manager,
+    PPICO_EXPORT_SLOT slots,
+    DWORD slotCapacity
+);
+
+/*
+ * Binds export slots to fixed modules. Each slot names an entry ID and tag;
+ * the manager fills its address whenever that module is loaded or updated
+ * and clears it when the module is unloaded, so callers read it directly.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param exports - Array of slots with id and tag set (may be NULL if count is 0)
+ * @param count   - Number of slots
+ * @return TRUE on success, FALSE on invalid arguments
+ *
+ * Note: Slots of modules that are already loaded are filled at once. Bound
+ * IDs are fixed, so RemovePicoById() is refused while slots are bound. See
+ * PicoManifest.h for fixed module sets.
+ */
+BOOL PicoManagerBindExports(
+    PPICO_MANAGER manager,
+    PPICO_BOUND_EXPORT exports,
+    DWORD count
+);
+
+/*
+ * Retrieves an export by tag from whichever loaded PICO provides it.
+ * If several modules export the same tag, the one loaded first wins.
+ *
+ * @param manager  - Pointer to the PICO_MANAGER structure
+ * @param tag      - Export tag identifier
+ * @param provider - Optional output parameter: entry providing the export
+ * @return Export address as char*, or NULL if no loaded module exports the tag
+ */
+char* GetPicoExport(
+    PPICO_MANAGER manager,
+    int tag,
+    PPICO_ENTRY* provider
+);
+
+/*
+ * Allocates the manager arena, a RW region for manager-owned objects
+ * such as channels. Objects are carved out with a bump pointer and live
+ * until the manager is torn down.
+ *
+ * @param manager    - Pointer to the PICO_MANAGER structure
+ * @param arenaSize  - Size of the arena in bytes
+ * @return TRUE on success, FALSE if an arena already exists or allocation failed
+ */
+BOOL PicoManagerInitArena(
+    PPICO_MANAGER manager,
+    SIZE_T arenaSize
+);
+
+/*
+ * Carves zero-initialized memory out of the manager arena.
+ *
+ * @param manager    - Pointer to the PICO_MANAGER structure
+ * @param size       - Number of bytes to allocate
+ * @param alignment  - Required alignment (power of two)
+ * @return Pointer to the memory, or NULL if the arena is missing or exhausted
+ */
+char* PicoManagerArenaAlloc(
+    PPICO_MANAGER manager,
+    SIZE_T size,
+    SIZE_T alignment
+);
+
+/*
+ * Creates a named bounded ring channel in the manager arena.
+ * Send and receive never lock; SPSC channels allow one producer thread,
+ * MPSC channels any number of producer threads. Both allow one consumer.
+ *
+ * @param manager   - Pointer to the PICO_MANAGER structure
+ * @param name      - Channel name (null-terminated string)
+ * @param kind      - PICO_CHANNEL_SPSC or PICO_CHANNEL_MPSC
+ * @param itemSize  - Size of one item in bytes
+ * @param capacity  - Number of items the channel holds (power of two)
+ * @return Pointer to the channel, or NULL if the name is taken, arguments
+ *         are invalid (including a ring too big for SIZE_T) or the arena is exhausted
+ */
+PPICO_CHANNEL CreatePicoChannel(
+    PPICO_MANAGER manager,
+    const char* name,
+    DWORD kind,
+    DWORD itemSize,
+    DWORD capacity
+);
+
+/*
+ * Retrieves a channel by its name.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param name    - Channel name (null-terminated string)
+ * @return Pointer to PICO_CHANNEL, or NULL if not found
+ */
+PPICO_CHANNEL GetPicoChannel(
+    PPICO_MANAGER manager,
+    const char* name
+);
+
+/*
+ * Enqueues up to count items into a channel.
+ *
+ * @param channel - Pointer to the PICO_CHANNEL
+ * @param items   - Items to enqueue (count * itemSize bytes)
+ * @param count   - Number of items to enqueue
+ * @return Number of items enqueued (less than count if the channel is full)
+ */
+DWORD PicoChannelSend(
+    PPICO_CHANNEL channel,
+    const void* items,
+    DWORD count
+);
+
+/*
+ * Dequeues up to count items from a channel.
+ *
+ * @param channel - Pointer to the PICO_CHANNEL
+ * @param items   - Output buffer (count * itemSize bytes)
+ * @param count   - Maximum number of items to dequeue
+ * @return Number of items dequeued (0 if the channel is empty)
+ */
+DWORD PicoChannelReceive(
+    PPICO_CHANNEL channel,
+    void* items,
+    DWORD count
+);
+
+/*
+ * Starts the manager's work-stealing executor.
+ * Workers, deques and inboxes are carved out of the manager arena by the
+ * first start; a restart reuses them.
+ *
+ * @param manager       - Pointer to the PICO_MANAGER structure (must have an arena)
+ * @param workerCount   - Number of worker threads
+ * @param taskCapacity  - Deque and inbox slots per worker (power of two)
+ * @return TRUE on success, FALSE if an executor is running, arguments are
+ *         invalid, the arena is exhausted or a thread could not be created
+ *
+ * Note: A restart may not ask for more workers or task slots than the
+ *       first start did.
+ */
+BOOL PicoExecutorStart(
+    PPICO_MANAGER manager,
+    DWORD workerCount,
+    DWORD taskCapacity
+);
+
+/*
+ * Stops the executor once all queued tasks have run and joins its workers.
+ * Submissions racing the stop are refused, or left in a queue and marked
+ * PICO_TASK_FAILED with their hold on the module released.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @return TRUE on success, FALSE if no executor is running
+ */
+BOOL PicoExecutorStop(
+    PPICO_MANAGER manager
+);
+
+/*
+ * Submits a task running a function of a loaded PICO.
+ * The caller fills task->entry, task->function (NULL for the entry point)
+ * and task->arg, and keeps the task alive until it is done.
+ * The entry's activeTasks count is held until the function returns, so the
+ * module cannot be removed while the task is queued or running. A task
+ * with no entry runs task->function and holds nothing.
+ * When all queues are full, the task runs on the calling thread.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param task    - Pointer to the caller-owned PICO_TASK
+ * @return TRUE on success, FALSE if no executor is running or it is
+ *         stopping, the PICO is not loaded or the manager has claimed it
+ */
+BOOL SubmitPicoTask(
+    PPICO_MANAGER manager,
+    PPICO_TASK task
+);
+
+/*
+ * Waits until a submitted task is done.
+ * The waiting thread steals and runs other tasks meanwhile.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param task    - Pointer to the submitted PICO_TASK
+ * @return TRUE once the task is done, FALSE on invalid arguments, if the
+ *         task failed or no executor is running to finish it
+ */
+BOOL WaitPicoTask(
+    PPICO_MANAGER manager,
+    PPICO_TASK task
+);
+
+/*
+ * Claims an entry for the manager: succeeds only with no task queued or
+ * running its code, and keeps SubmitPicoTask from starting new ones
+ * until PicoEntryUnclaim. The check and the claim are one interlocked
+ * operation, so a submission cannot slip in between.
+ *
+ * @param entry - Pointer to the PICO_ENTRY
+ * @return TRUE if claimed, FALSE if tasks hold the entry or it is claimed already
+ */
+BOOL PicoEntryClaim(
+    PPICO_ENTRY entry
+);
+
+/*
+ * Releases a claim taken by PicoEntryClaim.
+ *
+ * @param entry - Pointer to the claimed PICO_ENTRY
+ */
+void PicoEntryUnclaim(
+    PPICO_ENTRY entry
+);
+
+/*
+ * Sets the allocator used for the manager's code block, data sections and
+ * arena. Must be called before the manager owns any memory.
+ *
+ * @param manager   - Pointer to the PICO_MANAGER structure
+ * @param allocator - Pointer to a caller-owned PICO_ALLOCATOR (NULL for VirtualAlloc)
+ * @return TRUE on success, FALSE if memory is already allocated or a callback is missing
+ */
+BOOL PicoManagerSetAllocator(
+    PPICO_MANAGER manager,
+    PPICO_ALLOCATOR allocator
+);
+
+/*
+ * Sets the allocator used for vaults stored in a vault cache. Must be called
+ * while the cache holds no vaults.
+ *
+ * @param cache     - Pointer to the PICO_VAULT_CACHE structure
+ * @param allocator - Pointer to a caller-owned PICO_ALLOCATOR (NULL for VirtualAlloc)
+ * @return TRUE on success, FALSE if the cache is in use or a callback is missing
+ */
+BOOL PicoVaultCacheSetAllocator(
+    PPICO_VAULT_CACHE cache,
+    PPICO_ALLOCATOR allocator
+);
+
+/*
+ * Clears the manager's call statistics and turns timing on or off.
+ * Counts are kept in manager->stats.calls[operation][call] for every
+ * PICO_OP_* and PICO_CALL_* pair; ticks only accumulate while timing is on.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param timing  - TRUE to also accumulate time stamp counter ticks
+ * @return TRUE on success, FALSE on invalid arguments
+ *
+ * Example: PicoManagerResetStats(mgr, FALSE); LoadPico(mgr, -1, 0, &funcs);
+ *          mgr->stats.calls[PICO_OP_LOAD][PICO_CALL_GETPROCADDRESS]
+ */
+BOOL PicoManagerResetStats(
+    PPICO_MANAGER manager,
+    BOOL timing
+);
+
+/*
+ * Checks the code of loaded PICOs against the CRC32C recorded at load, a
+ * bounded amount per call. A cursor kept in the manager continues where
+ * the previous call stopped and wraps around, so repeated calls from idle
+ * time cover every module.
+ *
+ * @param manager   - Pointer to the PICO_MANAGER structure
+ * @param pageCount - Number of pages (PICO_PAGE_SIZE bytes) to check in this call
+ * @param corrupt   - Optional output parameter: entry whose code no longer matches
+ * @return FALSE if a module finished in this call does not match or manager is NULL, TRUE otherwise
+ */
+BOOL PicoManagerVerify(
+    PPICO_MANAGER manager,
+    DWORD pageCount,
+    PPICO_ENTRY* corrupt
+);
+
+/*
+ * Checks the whole code section of one PICO against its recorded CRC32C.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param id      - Numeric ID of the entry
+ * @return TRUE if the entry is loaded and intact, FALSE otherwise
+ */
+BOOL VerifyPicoById(
+    PPICO_MANAGER manager,
+    DWORD id
+);
+
+/*
+ * Computes a CRC32C (Castagnoli) checksum, using the SSE4.2 crc32
+ * instruction when the CPU has it. Calls can be chained by passing the
+ * previous result as crc. Each call checks CPUID; with a manager at hand,
+ * PicoManagerCrc32c checks it once.
+ *
+ * @param crc    - Previous checksum (0 to start)
+ * @param buffer - Pointer to the data
+ * @param size   - Size of the data in bytes
+ * @return Updated checksum
+ */
+DWORD PicoCrc32c(
+    DWORD crc,
+    const char* buffer,
+    SIZE_T size
+);
+
+/*
+ * Computes a CRC32C like PicoCrc32c, checking CPUID only on the manager's
+ * first checksum and keeping the answer in crcSupport.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param crc     - Previous checksum (0 to start)
+ * @param buffer  - Pointer to the data
+ * @param size    - Size of the data in bytes
+ * @return Updated checksum
+ */
+DWORD PicoManagerCrc32c(
+    PPICO_MANAGER manager,
+    DWORD crc,
+    const char* buffer,
+    SIZE_T size
+);
+
+/*
+ * Initializes a vault cache over caller-provided storage.
+ * The cache can be shared by any number of managers.
+ *
+ * @param cache          - Pointer to the PICO_VAULT_CACHE structure
+ * @param slots          - Pointer to the array of PICO_VAULT_INFO structures
+ * @param slotCapacity   - Number of slots in the array (must be a power of two)
+ * @param exports        - Storage for export indexes (NULL to not index exports)
+ * @param exportCapacity - Number of PICO_VAULT_EXPORT records in the storage
+ * @return TRUE on success, FALSE if arguments are invalid
+ */
+BOOL PicoVaultCacheInit(
+    PPICO_VAULT_CACHE cache,
+    PPICO_VAULT_INFO slots,
+    DWORD slotCapacity,
+    PPICO_VAULT_EXPORT exports,
+    DWORD exportCapacity
+);
+
+/*
+ * Attaches a vault cache to a manager. Vaults registered afterwards share
+ * their parsed information through the cache.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param cache   - Pointer to an initialized PICO_VAULT_CACHE (NULL to detach)
+ * @return TRUE on success, FALSE if manager is NULL
+ */
+BOOL PicoManagerSetVaultCache(
+    PPICO_MANAGER manager,
+    PPICO_VAULT_CACHE cache
+);
+
+/*
+ * Finds the cache slot of a vault's content, parsing and inserting it on
+ * first sight, and takes a reference on it. Slots are keyed by the vault
+ * header: the buffer a slot was filled from matches by pointer, any other
+ * buffer is compared with it byte for byte.
+ *
+ * @param cache - Pointer to the PICO_VAULT_CACHE structure
+ * @param vault - Pointer to the PICO buffer
+ * @return Pointer to the shared PICO_VAULT_INFO, or NULL if the cache is full
+ *
+ * Note: The cache keeps the pointer, not a copy. The buffer must stay
+ * allocated and unchanged until the last reference to the slot is released;
+ * a buffer rewritten in place would still match its old slot. Use
+ * PicoVaultStorePut for buffers that do not live that long.
+ */
+PPICO_VAULT_INFO PicoVaultCacheLookup(
+    PPICO_VAULT_CACHE cache,
+    char* vault
+);
+
+/*
+ * Stores a vault in the cache: the cache keeps its own copy of the buffer
+ * and frees it, with its export index, once the last reference is released.
+ * Identical contents are stored once.
+ *
+ * @param cache - Pointer to the PICO_VAULT_CACHE structure
+ * @param vault - Pointer to the PICO buffer (may be freed by the caller afterwards)
+ * @return Pointer to the PICO_VAULT_INFO with a reference held by the caller,
+ *         or NULL if the cache is full or allocation failed
+ *
+ * Note: Register info->vault with AddPico on managers using this cache, then
+ * drop the caller's reference with PicoVaultRelease.
+ */
+PPICO_VAULT_INFO PicoVaultStorePut(
+    PPICO_VAULT_CACHE cache,
+    char* vault
+);
+
+/*
+ * Drops a reference on a vault cache slot. The last reference frees a
+ * stored vault and releases the slot.
+ *
+ * @param info - Pointer to the PICO_VAULT_INFO (NULL is ignored)
+ */
+void PicoVaultRelease(
+    PPICO_VAULT_INFO info
+);
+
+/*
+ * Computes a non-cryptographic 64-bit fingerprint of a buffer.
+ *
+ * @param buffer - Pointer to the data
+ * @param size   - Size of the data in bytes
+ * @return Fingerprint, never 0
+ */
+DWORD64 PicoFingerprint(
+    const char* buffer,
+    SIZE_T size
+);
+
+/*
+ * Brings up a manager with a single reservation. The footprint of the code
+ * block, data sections, entry table, export registry, name index and arena (including
+ * import caches) is computed from the vaults, reserved at once and carved
+ * into regions; the vaults are then registered but not loaded.
+ *
+ * @param manager        - Pointer to a PICO_MANAGER initialized with PicoManagerInit (entries may be NULL)
+ * @param vaults         - Array of PICO buffers
+ * @param names          - Array of module names, one per vault
+ * @param count          - Number of vaults
+ * @param entryCapacity  - Capacity of the entry table (at least count)
+ * @param finalPadding   - Additional padding in bytes to reserve at end of the code block
+ * @param arenaSize      - Arena bytes for channels and executor state, on top of import caches
+ * @return TRUE on success, FALSE if arguments are invalid, the manager is in use, reservation
+ *         failed or a vault could not be registered (the reservation is released again)
+ *
+ * Note: Set the allocator, vault cache and interPicoPadding before bootstrapping.
+ * DestroyManager(manager, manager->baseAddress) releases the whole reservation.
+ * PICOs added later get their data sections allocated per load as usual.
+ */
+BOOL PicoManagerBootstrap(
+    PPICO_MANAGER manager,
+    char** vaults,
+    const char** names,
+    DWORD count,
+    DWORD entryCapacity,
+    SIZE_T finalPadding,
+    SIZE_T arenaSize
+);
+
+/*
+ * Calculates the size of the blob PicoManagerCheckpoint will write.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @return Size of the checkpoint blob in bytes, or 0 on invalid arguments
+ */
+SIZE_T PicoManagerCheckpointSize(
+    PPICO_MANAGER manager
+);
+
+/*
+ * Serializes the manager into one blob: entries, block layout, dependency
+ * declarations, vaults (which carry the relocation and import directives)
+ * and the images of all loaded PICOs as they are in memory.
+ *
+ * @param manager   - Pointer to the PICO_MANAGER structure
+ * @param blob      - Output buffer
+ * @param blobSize  - Size of the output buffer (see PicoManagerCheckpointSize)
+ * @return TRUE on success, FALSE if the buffer is too small or arguments are invalid
+ *
+ * Note: Quiesce modules first. Loader-patched pointers in the images are
+ * rebased on restore; anything else a module stored (heap pointers, handles)
+ * is restored byte for byte. The header carries the blob size and a CRC32C
+ * of the whole blob for PicoManagerRestore to check.
+ */
+BOOL PicoManagerCheckpoint(
+    PPICO_MANAGER manager,
+    char* blob,
+    SIZE_T blobSize
+);
+
+/*
+ * Rebuilds a manager from a checkpoint blob at whatever address a new RWX
+ * block lands. The blob is checked before anything is allocated: magic,
+ * version, pointer size, recorded size against blobSize, CRC32C, and that
+ * every record, vault and image lies inside it and fits the recorded block.
+ * Each vault is walked within its recorded size: its directive stream must
+ * end in PICO_INST_COMPLETE, import names in a NUL, and every patch, copy,
+ * export and the entry point must stay inside the image and resources.
+ * The CRC only catches accidental damage; this is what keeps a crafted blob
+ * with a recomputed CRC from steering the loader outside the image.
+ * Images are copied back and relocated to the new base: the relocation
+ * deltas are applied to every loader patch and imports are resolved again.
+ * A base the images cannot be relocated to (a smaller block, data out of
+ * rel32 reach, an import that does not resolve) is refused: the restore is
+ * undone and the manager left empty. Data sections are co-located with the
+ * block as with PicoManagerAlloc.
+ *
+ * @param manager  - Pointer to an initialized, empty PICO_MANAGER structure
+ * @param blob     - Checkpoint blob (must stay valid: entries reference its vault copies)
+ * @param blobSize - Size of the blob buffer in bytes
+ * @param funcs    - Import functions structure used to resolve imports
+ * @return TRUE on success, FALSE if the blob is invalid, corrupt, truncated
+ *         or was written by another architecture, the manager is not empty,
+ *         allocation failed or an image could not be relocated
+ *
+ * Note: Enable the arena, export registry or name index before restoring to have them
+ * populated during the restore. Import caches carved from the arena by an
+ * undone restore stay allocated.
+ */
+BOOL PicoManagerRestore(
+    PPICO_MANAGER manager,
+    char* blob,
+    SIZE_T blobSize,
+    IMPORTFUNCS * funcs
+);
+
 /*
  * Calculates the total code size required for all registered PICO modules.
  * Includes padding between modules but excludes final padding.
@@ -221,6 +1543,46 @@ char* GetPicoExportByName(
  */
 SIZE_T TotalCodeSize(PPICO_MANAGER manager);
 
+/*
+ * Describes the code block: one region per slot, padding, hole and the
+ * free tail, in block order, plus the data section of each loaded PICO.
+ *
+ * @param manager  - Pointer to the PICO_MANAGER structure
+ * @param layout   - Receives the summary; regionCount is the number of regions in the map
+ * @param regions  - Array receiving the regions (may be NULL if capacity is 0)
+ * @param capacity - Number of regions the array can hold
+ * @return TRUE if the whole map fit, FALSE if it did not or on invalid arguments
+ *
+ * Note: Call with a capacity of 0 to learn regionCount first. Loaded code is
+ * reported where it actually is; unloaded slots where LoadPico would put them.
+ */
+BOOL PicoManagerLayout(
+    PPICO_MANAGER manager,
+    PPICO_LAYOUT layout,
+    PPICO_LAYOUT_REGION regions,
+    DWORD capacity
+);
+
+/*
+ * Writes the block map as text, one line for the block and one per region:
+ *
+ *   block 0x1d0000 size 0x3000 used 0x1810 required 0x1820 free 0x1fe0 largest 0x17e0 padding 0x10 padded 0x20 data 0x400
+ *   +0x0 code 0x1000 #0 first data 0x2a0000 0x400
+ *   +0x1000 padding 0x10
+ *   +0x1010 unloaded 0x800 #1 second
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @param buffer  - Buffer receiving the NUL terminated text (may be NULL if size is 0)
+ * @param size    - Size of the buffer in bytes
+ * @return Length of the full text without the terminator; the text is cut
+ *         short if this is not less than size
+ */
+SIZE_T PicoManagerLayoutText(
+    PPICO_MANAGER manager,
+    char* buffer,
+    SIZE_T size
+);
+
 /*
  * Duplicates the PICO manager and calculates required memory for all registered PICOs.
  * Creates a new manager with proper sizing, but does NOT allocate the code sections yet.
@@ -249,12 +1611,16 @@ BOOL DuplicateManager(
  * Destroys a PICO manager and frees its RWX memory block.
  * Does NOT free the vault buffers (PICO data) - caller is responsible.
  * Does NOT free data sections (they're freed individually during removal).
+ * Drops the entries' vault cache references. A running executor is
+ * stopped first, its queues drained and its workers joined.
  *
  * @param manager    - Pointer to the PICO_MANAGER to destroy
- * @param picoBlock  - Address of the RWX memory block to free
- * @return TRUE on success, FALSE on invalid arguments
+ * @param picoBlock  - The manager's code block (manager->baseAddress), or NULL
+ * @return TRUE on success, FALSE on invalid arguments, if picoBlock is not the
+ *         manager's block, or if executor tasks still run module code
  *
- * Note: After destruction, vault pointers in entries are still valid.
+ * Note: After destruction, vault pointers in entries are still valid, unless
+ * they were stored in a vault cache and this manager held the last reference.
  * This allows reusing vaults in a new manager created with DuplicateManager().
  */
 BOOL DestroyManager(
@@ -262,6 +1628,29 @@ BOOL DestroyManager(
     char* picoBlock
 );
 
+/*
+ * Tears a manager down completely: stops the executor, releases the code
+ * block, every data section and the arena (or the bootstrap reservation),
+ * drops vault cache references and clears the export indexes. The manager
+ * is left empty, as after PicoManagerInit with the same entry table, and
+ * keeps its allocator, vault cache, padding, options and statistics.
+ *
+ * @param manager - Pointer to the PICO_MANAGER structure
+ * @return TRUE on success, FALSE on invalid arguments, if executor tasks
+ *         still run module code, or the executor could not be stopped
+ *
+ * Note: Data sections in data slots (co-located by PicoManagerAlloc, in the
+ * bootstrap reservation or in the PICO_BLOCK_DATA_ARENA data arena) need no
+ * call of their own. Every other loaded PICO costs one release call, so
+ * without slots the OS calls grow with the number of modules: PICOs added
+ * after PicoManagerAlloc, a caller-assigned block and large pages have no
+ * co-located slots, and only PICO_BLOCK_DATA_ARENA keeps those O(1).
+ * Vault buffers stay the caller's.
+ */
+BOOL PicoManagerTeardown(
+    PPICO_MANAGER manager
+);
+
 // linker intrinsic to map a function hash to a hook registered via Crystal Palace
 FARPROC __resolve_hook(DWORD funcHash);
 
@@ -271,10 +1660,19 @@ FARPROC __resolve_hook(DWORD funcHash);
 typedef void (*PICOMAIN_FUNC)(char * arg);
 
 PICOMAIN_FUNC PicoGetExport(char * src, char * base, int tag);
+char * PicoNextExport(char * src, char * cursor, int * tag, int * offset);
 PICOMAIN_FUNC PicoEntryPoint(char * src, char * base);
 int PicoCodeSize(char * src);
 int PicoDataSize(char * src);
 void PicoLoad(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData);
+int PicoImportCount(char * src);
+void PicoCaptureImports(char * src, char * dstData, ULONG_PTR * slots);
+void PicoResetData(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData, ULONG_PTR * slots);
+int PicoVaultSize(char * src);
+void PicoResolveCount(char * src, int * libraries, int * procedures);
+void PicoLoadCode(char * src, char * dstCode, char * dstData);
+BOOL PicoSameData(char * srcA, char * srcB);
+BOOL PicoRebase(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData, char * oldCode, char * oldData);
 
 /*
  * A macro to figure out our caller
@@ -287,4 +1685,8 @@ void PicoLoad(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData);
 #define WIN_GET_CALLER() _ReturnAddress()
 #endif
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* PICO_MANAGER_H */
\ No newline at end of file
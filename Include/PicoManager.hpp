@@ -0,0 +1,309 @@
+/*
+ * PICO Manager Library - C++ layer
+ *
+ * Optional header-only C++17 wrapper over PicoManager.h. Managers and loaded
+ * modules are owned RAII style, module names are hashed at compile time so
+ * by-name lookups go straight to the entries' name hashes, and exports are
+ * returned as the function type the caller asks for. Every member is an
+ * inline call to the C API; nothing is allocated and nothing throws.
+ * Manifest is the C++ form of the fixed module sets of PicoManifest.h.
+ */
+
+#ifndef PICO_MANAGER_HPP
+#define PICO_MANAGER_HPP
+
+#include "PicoManager.h"
+
+namespace pico {
+
+/*
+ * Module name together with its PicoNameHash.
+ * Hashed at compile time when built in a constant expression: a constexpr
+ * variable, or PICO_NAME("...") anywhere else.
+ */
+class Name {
+public:
+    template <SIZE_T N>
+    constexpr Name(const char (&text)[N]) : text_(text), hash_(Hash(text, N - 1)) {}
+
+    constexpr Name(const char* text, DWORD hash) : text_(text), hash_(hash) {}
+
+    /* Same result as PicoNameHash for the first length characters */
+    static constexpr DWORD Hash(const char* text, SIZE_T length) {
+        DWORD hash = PICO_NAME_HASH_BASIS;
+
+        for (SIZE_T i = 0; i < length && i < PICO_NAME_MAX_LENGTH - 1 && text[i]; i++) {
+            hash = (hash ^ (unsigned char)text[i]) * PICO_NAME_HASH_PRIME;
+        }
+
+        return hash;
+    }
+
+    constexpr const char* Text() const { return text_; }
+    constexpr DWORD Value() const { return hash_; }
+
+private:
+    const char* text_;
+    DWORD hash_;
+};
+
+/* Forces a hash to be a compile time constant */
+template <DWORD Value>
+struct NameHash {
+    static constexpr DWORD value = Value;
+};
+
+/*
+ * Reference to a loaded module. Every Use() of a module hands out one more
+ * reference, counted in the owning manager; the module is unloaded
+ * (UnloadPicoById) when the last one goes out of scope or is reset, and
+ * stays loaded if the last one is released.
+ * Removing an earlier entry moves this one, so release or reset it first.
+ */
+class Module {
+public:
+    Module() noexcept : manager_(nullptr), entry_(nullptr), uses_(nullptr) {}
+
+    /* Takes one more reference on uses, the entry's count in its manager */
+    Module(PPICO_MANAGER manager, PPICO_ENTRY entry, LONG* uses) noexcept : manager_(manager), entry_(entry), uses_(entry ? uses : nullptr) {
+        if (uses_) __atomic_add_fetch(uses_, 1, __ATOMIC_RELAXED);
+    }
+
+    Module(Module&& other) noexcept : manager_(other.manager_), entry_(other.entry_), uses_(other.uses_) {
+        other.entry_ = nullptr;
+        other.uses_ = nullptr;
+    }
+
+    Module& operator=(Module&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            manager_ = other.manager_;
+            entry_ = other.entry_;
+            uses_ = other.uses_;
+            other.entry_ = nullptr;
+            other.uses_ = nullptr;
+        }
+        return *this;
+    }
+
+    Module(const Module&) = delete;
+    Module& operator=(const Module&) = delete;
+
+    ~Module() { Reset(); }
+
+    explicit operator bool() const { return entry_ != nullptr; }
+
+    PPICO_ENTRY Entry() const { return entry_; }
+    char* Code() const { return entry_->code; }
+    char* Data() const { return entry_->data; }
+
+    /* Export of this module cast to F, or null if it has no such tag */
+    template <typename F = PICOMAIN_FUNC>
+    F Export(int tag) const {
+        return reinterpret_cast<F>(GetPicoExportById(manager_, entry_->id, tag));
+    }
+
+    /* Entry point of this module cast to F */
+    template <typename F = PICOMAIN_FUNC>
+    F EntryPoint() const {
+        return reinterpret_cast<F>(PicoEntryPoint(entry_->vault, entry_->code));
+    }
+
+    BOOL ResetData() const { return ResetPicoById(manager_, entry_->id); }
+
+    /* Gives up this reference without unloading; the module stays loaded */
+    PPICO_ENTRY Release() noexcept {
+        PPICO_ENTRY entry = entry_;
+        if (uses_) __atomic_sub_fetch(uses_, 1, __ATOMIC_ACQ_REL);
+        entry_ = nullptr;
+        uses_ = nullptr;
+        return entry;
+    }
+
+    /* Drops this reference, unloading the module if it was the last one */
+    void Reset() noexcept {
+        if (uses_ && __atomic_sub_fetch(uses_, 1, __ATOMIC_ACQ_REL) == 0) {
+            UnloadPicoById(manager_, entry_->id);
+        }
+        entry_ = nullptr;
+        uses_ = nullptr;
+    }
+
+private:
+    PPICO_MANAGER manager_;
+    PPICO_ENTRY entry_;
+    LONG* uses_;
+};
+
+/*
+ * Manager with its entry table, a name index and, if ExportSlots is not 0,
+ * an export registry of that many slots (a power of two). Everything it owns is
+ * released (PicoManagerTeardown) when it goes out of scope.
+ * The manager points into itself, so it can be neither copied nor moved.
+ */
+template <DWORD Capacity, DWORD ExportSlots = 0>
+class Manager {
+public:
+    Manager() {
+        PicoManagerInit(&manager_, entries_, Capacity);
+        PicoManagerInitNames(&manager_, names_, NameSlots);
+        if (ExportSlots) PicoManagerInitExports(&manager_, slots_, ExportSlots);
+    }
+
+    Manager(const Manager&) = delete;
+    Manager& operator=(const Manager&) = delete;
+
+    ~Manager() { PicoManagerTeardown(&manager_); }
+
+    PPICO_MANAGER Raw() { return &manager_; }
+
+    BOOL Add(const Name& name, char* vault) { return AddPico(&manager_, name.Text(), vault); }
+    BOOL Alloc(SIZE_T finalPadding) { return PicoManagerAlloc(&manager_, finalPadding); }
+
+    BOOL Load(IMPORTFUNCS* funcs, DWORD upToEntryId = (DWORD)-1, SIZE_T finalPadding = 0) {
+        return LoadPico(&manager_, upToEntryId, finalPadding, funcs);
+    }
+
+    /* Entry by name, or null; loaded or not */
+    PPICO_ENTRY Find(const Name& name) { return GetPicoByHash(&manager_, name.Value(), name.Text()); }
+
+    /* Loads the module if needed (UsePicoById) and takes a reference to it */
+    Module Use(const Name& name) {
+        PPICO_ENTRY entry = Find(name);
+        if (!entry) return Module();
+
+        return Module(&manager_, UsePicoById(&manager_, entry->id), &uses_[entry->id]);
+    }
+
+    /* Export of whichever loaded module provides the tag, cast to F */
+    template <typename F = PICOMAIN_FUNC>
+    F Export(int tag) {
+        return reinterpret_cast<F>(GetPicoExport(&manager_, tag, nullptr));
+    }
+
+    /* Export of a named module cast to F, or null if it is not loaded or has no such tag */
+    template <typename F = PICOMAIN_FUNC>
+    F Export(const Name& name, int tag) {
+        PPICO_ENTRY entry = Find(name);
+        return entry ? reinterpret_cast<F>(GetPicoExportById(&manager_, entry->id, tag)) : nullptr;
+    }
+
+private:
+    /* Smallest power of two at least twice Capacity: the name index stays at most half full */
+    static constexpr DWORD NameSlots = [] {
+        DWORD slots = 2;
+        while (slots < 2 * Capacity) slots <<= 1;
+        return slots;
+    }();
+
+    PICO_MANAGER manager_;
+    PICO_ENTRY entries_[Capacity];
+    DWORD names_[NameSlots];
+    LONG uses_[Capacity] = {};
+    PICO_EXPORT_SLOT slots_[ExportSlots ? ExportSlots : 1];
+};
+
+/*
+ * Export a manifest declares: providing module's index and tag
+ */
+struct ExportSpec {
+    DWORD module;
+    int tag;
+};
+
+/*
+ * Fixed module set known at compile time. Modules and Exports are constexpr
+ * arrays of Name and ExportSpec; a module's index in Modules is its entry ID
+ * and an export's index in Exports is its bound slot (PicoManagerBindExports),
+ * so Entry<I>() and Export<I>() are indexed loads.
+ *
+ *   constexpr pico::Name kModules[] = { "hooks", "comms" };
+ *   constexpr pico::ExportSpec kExports[] = { { 1, TAG_SEND } };
+ *   pico::Manifest<kModules, kExports> app(vaults);
+ *   auto send = app.Export<0, SEND_FUNC>();
+ *
+ * IndexOf() resolves a name to its index at compile time.
+ */
+template <const auto& Modules, const auto& Exports>
+class Manifest {
+public:
+    static constexpr DWORD ModuleCount = sizeof(Modules) / sizeof(Modules[0]);
+    static constexpr DWORD ExportCount = sizeof(Exports) / sizeof(Exports[0]);
+
+    /* Index of a module name, ModuleCount if it is not in the manifest */
+    static constexpr DWORD IndexOf(const Name& name) {
+        for (DWORD i = 0; i < ModuleCount; i++) {
+            if (Modules[i].Value() == name.Value() && SameText(Modules[i].Text(), name.Text())) return i;
+        }
+        return ModuleCount;
+    }
+
+    /* Registers every module with its vault, vaults[i] for Modules[i] */
+    explicit Manifest(char* const (&vaults)[ModuleCount]) : valid_(TRUE) {
+        PicoManagerInit(&manager_, entries_, ModuleCount);
+        for (DWORD i = 0; i < ModuleCount; i++) {
+            if (!AddPico(&manager_, Modules[i].Text(), vaults[i])) valid_ = FALSE;
+        }
+        for (DWORD i = 0; i < ExportCount; i++) {
+            exports_[i].id = Exports[i].module;
+            exports_[i].tag = Exports[i].tag;
+        }
+        PicoManagerBindExports(&manager_, exports_, ExportCount);
+    }
+
+    Manifest(const Manifest&) = delete;
+    Manifest& operator=(const Manifest&) = delete;
+
+    ~Manifest() { PicoManagerTeardown(&manager_); }
+
+    /* FALSE if a module could not be registered */
+    BOOL Valid() const { return valid_; }
+
+    PPICO_MANAGER Raw() { return &manager_; }
+
+    BOOL Alloc(SIZE_T finalPadding) { return PicoManagerAlloc(&manager_, finalPadding); }
+
+    BOOL Load(IMPORTFUNCS* funcs, DWORD upToEntryId = (DWORD)-1, SIZE_T finalPadding = 0) {
+        return LoadPico(&manager_, upToEntryId, finalPadding, funcs);
+    }
+
+    template <DWORD Index>
+    PPICO_ENTRY Entry() {
+        static_assert(Index < ModuleCount, "module is not in the manifest");
+        return &entries_[Index];
+    }
+
+    /* Loads the module if needed (UsePicoById) and takes a reference to it */
+    template <DWORD Index>
+    Module Use() {
+        static_assert(Index < ModuleCount, "module is not in the manifest");
+        return Module(&manager_, UsePicoById(&manager_, Index), &uses_[Index]);
+    }
+
+    /* Bound export cast to F, null while its module is not loaded */
+    template <DWORD Index, typename F = PICOMAIN_FUNC>
+    F Export() const {
+        static_assert(Index < ExportCount, "export is not in the manifest");
+        return reinterpret_cast<F>(exports_[Index].address);
+    }
+
+private:
+    static constexpr bool SameText(const char* a, const char* b) {
+        SIZE_T i = 0;
+        for (; i < PICO_NAME_MAX_LENGTH - 1 && a[i] && a[i] == b[i]; i++) {}
+        return i == PICO_NAME_MAX_LENGTH - 1 || a[i] == b[i];
+    }
+
+    PICO_MANAGER manager_;
+    PICO_ENTRY entries_[ModuleCount];
+    LONG uses_[ModuleCount] = {};
+    PICO_BOUND_EXPORT exports_[ExportCount ? ExportCount : 1];
+    BOOL valid_;
+};
+
+} /* namespace pico */
+
+/* Name whose hash is computed at compile time, e.g. mgr.Use(PICO_NAME("comms")) */
+#define PICO_NAME(text) ::pico::Name((text), ::pico::NameHash<::pico::Name::Hash((text), sizeof(text) - 1)>::value)
+
+#endif /* PICO_MANAGER_HPP */
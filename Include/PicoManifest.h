@@ -0,0 +1,69 @@
+/*
+ * PICO Manager Library - Module manifest
+ *
+ * Declares a fixed module set at compile time. Modules get fixed entry IDs
+ * (their order in the list), the manifest type holds a statically sized
+ * entry table and one bound export slot per declared export, so looking up
+ * a module or export is an indexed load instead of a search.
+ *
+ *   #define APP_MODULES(MODULE)          \
+ *       MODULE(APP_HOOKS, "hooks")       \
+ *       MODULE(APP_COMMS, "comms")
+ *
+ *   #define APP_EXPORTS(EXPORT)          \
+ *       EXPORT(APP_SEND, APP_COMMS, 0x10) \
+ *       EXPORT(APP_RECV, APP_COMMS, 0x11)
+ *
+ *   PICO_MANIFEST(APP, APP_MODULES, APP_EXPORTS)
+ *
+ * declares the enums APP_HOOKS..APP_MODULE_COUNT and APP_SEND..APP_EXPORT_COUNT,
+ * the APP_MANIFEST type and APP_ManifestInit(). An empty export list is fine.
+ * C++ code can use pico::Manifest from PicoManager.hpp instead.
+ */
+
+#ifndef PICO_MANIFEST_H
+#define PICO_MANIFEST_H
+
+#include "PicoManager.h"
+
+/* List callbacks used by PICO_MANIFEST */
+#define PICO_MANIFEST_INDEX(id, name) id,
+#define PICO_MANIFEST_EXPORT_INDEX(id, module, tag) id,
+#define PICO_MANIFEST_ADD(id, name) \
+    if (!AddPico(&manifest->manager, name, vaults[id])) return FALSE;
+#define PICO_MANIFEST_BIND(slot, provider, value) \
+    manifest->exports[slot].id = provider; \
+    manifest->exports[slot].tag = value;
+
+/* Arrays cannot be empty */
+#define PICO_MANIFEST_SIZE(count) ((count) ? (count) : 1)
+
+/*
+ * Declares the manifest of prefix: module and export enums, the
+ * prefix##_MANIFEST type and prefix##_ManifestInit().
+ */
+#define PICO_MANIFEST(prefix, MODULES, EXPORTS)                                     \
+    enum { MODULES(PICO_MANIFEST_INDEX) prefix##_MODULE_COUNT };                    \
+    enum { EXPORTS(PICO_MANIFEST_EXPORT_INDEX) prefix##_EXPORT_COUNT };             \
+                                                                                    \
+    typedef struct {                                                                \
+        PICO_MANAGER manager;                                                       \
+        PICO_ENTRY entries[PICO_MANIFEST_SIZE(prefix##_MODULE_COUNT)];              \
+        PICO_BOUND_EXPORT exports[PICO_MANIFEST_SIZE(prefix##_EXPORT_COUNT)];       \
+    } prefix##_MANIFEST;                                                            \
+                                                                                    \
+    /* Registers every module with its vault (vaults[id]) and binds the exports */  \
+    static inline BOOL prefix##_ManifestInit(prefix##_MANIFEST* manifest, char* const* vaults) { \
+        PicoManagerInit(&manifest->manager, manifest->entries, prefix##_MODULE_COUNT); \
+        MODULES(PICO_MANIFEST_ADD)                                                  \
+        EXPORTS(PICO_MANIFEST_BIND)                                                 \
+        return PicoManagerBindExports(&manifest->manager, manifest->exports, prefix##_EXPORT_COUNT); \
+    }
+
+/* Entry of a manifest module, e.g. PICO_MANIFEST_ENTRY(&app, APP_COMMS) */
+#define PICO_MANIFEST_ENTRY(manifest, module) (&(manifest)->entries[module])
+
+/* Address of a manifest export (NULL while its module is not loaded) */
+#define PICO_MANIFEST_EXPORT(manifest, export) ((manifest)->exports[export].address)
+
+#endif /* PICO_MANIFEST_H */
@@ -0,0 +1,194 @@
+/*
+ * PICO Manager Library - Channels
+ *
+ * Bounded ring channels for module-to-module traffic. Channels are carved
+ * out of the manager arena, looked up by name, and never lock: producers
+ * and consumers only synchronize through their ring positions.
+ */
+
+#include <windows.h>
+#include "../Include/PicoManager.h"
+
+/* ========================================================================
+ * EXTERNAL FUNCTION DECLARATIONS
+ * ======================================================================== */
+
+DECLSPEC_IMPORT size_t __cdecl MSVCRT$strlen(const char* str);
+DECLSPEC_IMPORT int __cdecl MSVCRT$strncmp(const char* str1, const char* str2, size_t count);
+DECLSPEC_IMPORT char* __cdecl MSVCRT$strncpy(char* dest, const char* src, size_t count);
+
+/* ========================================================================
+ * CHANNEL MANAGEMENT FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Retrieves a channel by its name.
+ * Performs case-sensitive string comparison.
+ */
+PPICO_CHANNEL GetPicoChannel(PPICO_MANAGER manager, const char* name) {
+    if (!manager || !name) return NULL;
+
+    SIZE_T nameLen = MSVCRT$strlen(name);
+    if (nameLen >= PICO_NAME_MAX_LENGTH) {
+        nameLen = PICO_NAME_MAX_LENGTH - 1;
+    }
+
+    for (PPICO_CHANNEL channel = manager->channels; channel; channel = channel->next) {
+        if (MSVCRT$strncmp(channel->name, name, nameLen) == 0 && channel->name[nameLen] == '\0') {
+            return channel;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Creates a named channel in the manager arena.
+ * The channel header and its item ring are cache-line aligned.
+ */
+PPICO_CHANNEL CreatePicoChannel(PPICO_MANAGER manager, const char* name, DWORD kind, DWORD itemSize, DWORD capacity) {
+    if (!manager || !name || itemSize == 0) return NULL;
+    if (kind != PICO_CHANNEL_SPSC && kind != PICO_CHANNEL_MPSC) return NULL;
+    if (capacity < 2 || (capacity & (capacity - 1)) || capacity > 0x40000000) return NULL;
+    if (GetPicoChannel(manager, name)) return NULL;
+
+    /* The ring sizes below must not wrap, which they can with 32-bit SIZE_T */
+    SIZE_T unit = (itemSize > sizeof(LONG)) ? itemSize : sizeof(LONG);
+    if (capacity > ((SIZE_T)-1 - sizeof(PICO_CHANNEL) - 3 * PICO_CACHE_LINE) / unit) return NULL;
+
+    PPICO_CHANNEL channel = (PPICO_CHANNEL)PicoManagerArenaAlloc(manager, sizeof(PICO_CHANNEL), PICO_CACHE_LINE);
+    if (!channel) return NULL;
+
+    channel->items = PicoManagerArenaAlloc(manager, (SIZE_T)itemSize * capacity, PICO_CACHE_LINE);
+    if (!channel->items) return NULL;
+
+    /* MPSC slots carry a sequence so the consumer can tell when a claimed slot is written */
+    channel->sequence = NULL;
+    if (kind == PICO_CHANNEL_MPSC) {
+        channel->sequence = (volatile LONG*)PicoManagerArenaAlloc(manager, sizeof(LONG) * capacity, PICO_CACHE_LINE);
+        if (!channel->sequence) return NULL;
+
+        for (DWORD i = 0; i < capacity; i++) {
+            channel->sequence[i] = (LONG)i;
+        }
+    }
+
+    MSVCRT$strncpy(channel->name, name, PICO_NAME_MAX_LENGTH - 1);
+    channel->name[PICO_NAME_MAX_LENGTH - 1] = '\0';
+    channel->kind = kind;
+    channel->itemSize = itemSize;
+    channel->capacity = capacity;
+    channel->head = 0;
+    channel->tail = 0;
+
+    /* Publish it for lookups */
+    channel->next = manager->channels;
+    manager->channels = channel;
+
+    return channel;
+}
+
+/* ========================================================================
+ * CHANNEL TRAFFIC FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Copies items in or out of the ring, wrapping at most once.
+ */
+static void ChannelCopyIn(PPICO_CHANNEL channel, DWORD position, const char* src, DWORD count) {
+    DWORD mask = channel->capacity - 1;
+    DWORD first = channel->capacity - (position & mask);
+    if (first > count) first = count;
+
+    __movsb((unsigned char*)channel->items + (SIZE_T)(position & mask) * channel->itemSize, (const unsigned char*)src, (SIZE_T)first * channel->itemSize);
+    __movsb((unsigned char*)channel->items, (const unsigned char*)src + (SIZE_T)first * channel->itemSize, (SIZE_T)(count - first) * channel->itemSize);
+}
+
+static void ChannelCopyOut(PPICO_CHANNEL channel, DWORD position, char* dst, DWORD count) {
+    DWORD mask = channel->capacity - 1;
+    DWORD first = channel->capacity - (position & mask);
+    if (first > count) first = count;
+
+    __movsb((unsigned char*)dst, (const unsigned char*)channel->items + (SIZE_T)(position & mask) * channel->itemSize, (SIZE_T)first * channel->itemSize);
+    __movsb((unsigned char*)dst + (SIZE_T)first * channel->itemSize, (const unsigned char*)channel->items, (SIZE_T)(count - first) * channel->itemSize);
+}
+
+/*
+ * Enqueues up to count items.
+ * SPSC: the single producer owns tail and publishes it with a release store.
+ * MPSC: producers claim a range of slots with a CAS on tail, fill it, then
+ * publish each slot through its sequence.
+ */
+DWORD PicoChannelSend(PPICO_CHANNEL channel, const void* items, DWORD count) {
+    if (!channel || !items || count == 0) return 0;
+
+    if (channel->kind == PICO_CHANNEL_SPSC) {
+        DWORD tail = (DWORD)channel->tail;
+        DWORD head = (DWORD)__atomic_load_n(&channel->head, __ATOMIC_ACQUIRE);
+        DWORD space = channel->capacity - (tail - head);
+        if (count > space) count = space;
+        if (count == 0) return 0;
+
+        ChannelCopyIn(channel, tail, (const char*)items, count);
+        __atomic_store_n(&channel->tail, (LONG)(tail + count), __ATOMIC_RELEASE);
+        return count;
+    }
+
+    DWORD tail = (DWORD)__atomic_load_n(&channel->tail, __ATOMIC_RELAXED);
+    while (TRUE) {
+        DWORD head = (DWORD)__atomic_load_n(&channel->head, __ATOMIC_ACQUIRE);
+        DWORD space = channel->capacity - (tail - head);
+        DWORD claim = (count > space) ? space : count;
+        if (claim == 0) return 0;
+
+        LONG expected = (LONG)tail;
+        if (__atomic_compare_exchange_n(&channel->tail, &expected, (LONG)(tail + claim), FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            count = claim;
+            break;
+        }
+
+        tail = (DWORD)expected;
+    }
+
+    ChannelCopyIn(channel, tail, (const char*)items, count);
+
+    for (DWORD i = 0; i < count; i++) {
+        DWORD position = tail + i;
+        __atomic_store_n(&channel->sequence[position & (channel->capacity - 1)], (LONG)(position + 1), __ATOMIC_RELEASE);
+    }
+
+    return count;
+}
+
+/*
+ * Dequeues up to count items.
+ * MPSC: stops at the first claimed slot whose producer has not published yet.
+ */
+DWORD PicoChannelReceive(PPICO_CHANNEL channel, void* items, DWORD count) {
+    if (!channel || !items || count == 0) return 0;
+
+    DWORD head = (DWORD)channel->head;
+    DWORD available;
+
+    if (channel->kind == PICO_CHANNEL_SPSC) {
+        DWORD tail = (DWORD)__atomic_load_n(&channel->tail, __ATOMIC_ACQUIRE);
+        available = tail - head;
+    } else {
+        available = 0;
+        while (available < count) {
+            DWORD position = head + available;
+            LONG sequence = __atomic_load_n(&channel->sequence[position & (channel->capacity - 1)], __ATOMIC_ACQUIRE);
+            if (sequence != (LONG)(position + 1)) break;
+            available++;
+        }
+    }
+
+    if (count > available) count = available;
+    if (count == 0) return 0;
+
+    ChannelCopyOut(channel, head, (char*)items, count);
+
+    /* Hand the slots back to producers only after they have been read */
+    __atomic_store_n(&channel->head, (LONG)(head + count), __ATOMIC_RELEASE);
+    return count;
+}
@@ -0,0 +1,202 @@
+/*
+ * PICO Manager Library - Delta
+ *
+ * Compact binary deltas between two vaults. A delta is a list of copies out
+ * of the old vault and literal bytes, so it only carries what changed.
+ * UpdatePicoById takes the reconstructed vault from here.
+ */
+
+#include <windows.h>
+#include "../Include/PicoManager.h"
+
+/* Shortest match worth a copy operation instead of literal bytes */
+#define DELTA_MIN_MATCH 16
+
+/* Bytes hashed to find match candidates */
+#define DELTA_HASH_BYTES 8
+
+/* Vault content carries no alignment guarantee */
+typedef DWORD64 __attribute__((aligned(1), may_alias)) UNALIGNED_DWORD64;
+
+/* ========================================================================
+ * ENCODING FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Hash table slot of the DELTA_HASH_BYTES bytes at p.
+ */
+static DWORD DeltaHash(const char* p, DWORD mask) {
+    DWORD64 value = *(const UNALIGNED_DWORD64*)p * 0x9E3779B97F4A7C15ULL;
+    return (DWORD)(value >> 32) & mask;
+}
+
+/*
+ * Number of equal bytes at a and b, up to limit.
+ */
+static DWORD DeltaMatch(const char* a, const char* b, DWORD limit) {
+    DWORD length = 0;
+
+    while (length < limit && a[length] == b[length]) {
+        length++;
+    }
+    return length;
+}
+
+/*
+ * Appends one operation, and the literal bytes of an add, to the delta.
+ */
+static BOOL DeltaEmit(char* delta, DWORD capacity, DWORD* used, DWORD type, DWORD offset, DWORD length, const char* bytes) {
+    DWORD size = sizeof(PICO_DELTA_OP) + ((type == PICO_DELTA_ADD) ? ((length + 3) & ~3) : 0);
+
+    if (length == 0) return TRUE;
+    if (size > capacity - *used) return FALSE;
+
+    PPICO_DELTA_OP op = (PPICO_DELTA_OP)(delta + *used);
+    op->type = type;
+    op->offset = offset;
+    op->length = length;
+
+    if (type == PICO_DELTA_ADD) {
+        __movsb((unsigned char*)(op + 1), (const unsigned char*)bytes, length);
+    }
+
+    *used += size;
+    return TRUE;
+}
+
+/*
+ * Encodes newVault as copies out of oldVault plus literals. Candidates
+ * come from the same shift as the previous copy first, so in-place edits
+ * cost one literal and one copy, then from a hash of every old position.
+ */
+DWORD PicoDeltaCreate(
+    char* oldVault,
+    DWORD oldSize,
+    char* newVault,
+    DWORD newSize,
+    char* delta,
+    DWORD deltaCapacity,
+    DWORD* table,
+    DWORD tableCapacity
+) {
+    if (!oldVault || !newVault || !delta || !table) return 0;
+    if (tableCapacity < 2 || (tableCapacity & (tableCapacity - 1))) return 0;
+    if (deltaCapacity < sizeof(PICO_DELTA_HDR)) return 0;
+
+    DWORD mask = tableCapacity - 1;
+    DWORD used = sizeof(PICO_DELTA_HDR);
+
+    __stosb((unsigned char*)table, 0, sizeof(DWORD) * tableCapacity);
+    for (DWORD i = 0; i + DELTA_HASH_BYTES <= oldSize; i++) {
+        table[DeltaHash(oldVault + i, mask)] = i + 1;
+    }
+
+    DWORD position = 0;
+    DWORD literal = 0;
+    DWORD oldEnd = 0;
+
+    while (position + DELTA_HASH_BYTES <= newSize) {
+        DWORD candidates[2];
+        DWORD best = 0;
+        DWORD bestLength = 0;
+
+        candidates[0] = oldEnd + (position - literal);
+        candidates[1] = table[DeltaHash(newVault + position, mask)];
+        candidates[1] = candidates[1] ? candidates[1] - 1 : (DWORD)-1;
+
+        for (DWORD c = 0; c < 2; c++) {
+            DWORD start = candidates[c];
+            if (start >= oldSize) continue;
+
+            DWORD limit = oldSize - start;
+            if (limit > newSize - position) limit = newSize - position;
+
+            DWORD length = DeltaMatch(oldVault + start, newVault + position, limit);
+            if (length > bestLength) {
+                best = start;
+                bestLength = length;
+            }
+        }
+
+        if (bestLength < DELTA_MIN_MATCH) {
+            position++;
+            continue;
+        }
+
+        /* Grow the match backwards over literal bytes that match too */
+        while (position > literal && best > 0 && oldVault[best - 1] == newVault[position - 1]) {
+            position--;
+            best--;
+            bestLength++;
+        }
+
+        if (!DeltaEmit(delta, deltaCapacity, &used, PICO_DELTA_ADD, 0, position - literal, newVault + literal) ||
+            !DeltaEmit(delta, deltaCapacity, &used, PICO_DELTA_COPY, best, bestLength, NULL)) {
+            return 0;
+        }
+
+        position += bestLength;
+        literal = position;
+        oldEnd = best + bestLength;
+    }
+
+    if (!DeltaEmit(delta, deltaCapacity, &used, PICO_DELTA_ADD, 0, newSize - literal, newVault + literal)) {
+        return 0;
+    }
+
+    PPICO_DELTA_HDR hdr = (PPICO_DELTA_HDR)delta;
+    hdr->magic = PICO_DELTA_MAGIC;
+    hdr->oldSize = oldSize;
+    hdr->oldCrc = PicoCrc32c(0, oldVault, oldSize);
+    hdr->newSize = newSize;
+    hdr->newCrc = PicoCrc32c(0, newVault, newSize);
+    hdr->deltaSize = used;
+    return used;
+}
+
+/* ========================================================================
+ * DECODING FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Rebuilds the new vault. The header must agree with the buffers it came
+ * with before anything is read past them, and both ends are checked by
+ * CRC32C, so a delta applied to the wrong base or damaged in transit is refused.
+ */
+BOOL PicoDeltaApply(char* oldVault, DWORD oldSize, char* delta, DWORD deltaSize, char* newVault, DWORD newCapacity) {
+    if (!oldVault || !delta || !newVault) return FALSE;
+    if (deltaSize < sizeof(PICO_DELTA_HDR)) return FALSE;
+
+    PPICO_DELTA_HDR hdr = (PPICO_DELTA_HDR)delta;
+    if (hdr->magic != PICO_DELTA_MAGIC || hdr->deltaSize != deltaSize || hdr->oldSize != oldSize) return FALSE;
+    if (hdr->newSize > newCapacity) return FALSE;
+    if (PicoCrc32c(0, oldVault, hdr->oldSize) != hdr->oldCrc) return FALSE;
+
+    DWORD cursor = sizeof(PICO_DELTA_HDR);
+    DWORD written = 0;
+
+    while (cursor < hdr->deltaSize) {
+        if (hdr->deltaSize - cursor < sizeof(PICO_DELTA_OP)) return FALSE;
+
+        PPICO_DELTA_OP op = (PPICO_DELTA_OP)(delta + cursor);
+        cursor += sizeof(PICO_DELTA_OP);
+
+        if (op->length > hdr->newSize - written) return FALSE;
+
+        if (op->type == PICO_DELTA_COPY) {
+            if (op->offset > hdr->oldSize || op->length > hdr->oldSize - op->offset) return FALSE;
+            __movsb((unsigned char*)newVault + written, (unsigned char*)oldVault + op->offset, op->length);
+        } else if (op->type == PICO_DELTA_ADD) {
+            DWORD padded = (op->length + 3) & ~3;
+            if (padded > hdr->deltaSize - cursor) return FALSE;
+            __movsb((unsigned char*)newVault + written, (unsigned char*)delta + cursor, op->length);
+            cursor += padded;
+        } else {
+            return FALSE;
+        }
+
+        written += op->length;
+    }
+
+    return written == hdr->newSize && PicoCrc32c(0, newVault, written) == hdr->newCrc;
+}
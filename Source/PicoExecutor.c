@@ -0,0 +1,465 @@
+/*
+ * PICO Manager Library - Executor
+ *
+ * A small work-stealing thread pool owned by the manager. It runs module
+ * entry points and exports as tasks so long-running commands do not block
+ * the caller. Each worker owns a deque (Chase-Lev, fixed size) and an MPSC
+ * inbox channel for tasks submitted from outside the pool.
+ */
+
+#include <windows.h>
+#include "../Include/PicoManager.h"
+#include "PicoInternal.h"
+
+/* ========================================================================
+ * EXTERNAL FUNCTION DECLARATIONS
+ * ======================================================================== */
+
+WINBASEAPI HANDLE WINAPI KERNEL32$CreateThread(LPSECURITY_ATTRIBUTES lpThreadAttributes, SIZE_T dwStackSize, LPTHREAD_START_ROUTINE lpStartAddress, LPVOID lpParameter, DWORD dwCreationFlags, LPDWORD lpThreadId);
+WINBASEAPI HANDLE WINAPI KERNEL32$CreateSemaphoreA(LPSECURITY_ATTRIBUTES lpSemaphoreAttributes, LONG lInitialCount, LONG lMaximumCount, LPCSTR lpName);
+WINBASEAPI BOOL WINAPI KERNEL32$ReleaseSemaphore(HANDLE hSemaphore, LONG lReleaseCount, LPLONG lpPreviousCount);
+WINBASEAPI DWORD WINAPI KERNEL32$WaitForSingleObject(HANDLE hHandle, DWORD dwMilliseconds);
+WINBASEAPI DWORD WINAPI KERNEL32$GetCurrentThreadId(void);
+WINBASEAPI BOOL WINAPI KERNEL32$SwitchToThread(void);
+WINBASEAPI BOOL WINAPI KERNEL32$CloseHandle(HANDLE hObject);
+
+/* Idle workers re-check the queues at least this often (ms) */
+#define PICO_EXECUTOR_IDLE_WAIT 10
+
+/* Inbox items drained into the deque per pass */
+#define PICO_EXECUTOR_DRAIN 16
+
+/* ========================================================================
+ * DEQUE FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Pushes a task at the owner end. Only the owning worker calls this.
+ * Returns FALSE if the deque is full.
+ */
+static BOOL DequePush(PPICO_WORKER worker, PPICO_TASK task) {
+    LONG bottom = __atomic_load_n(&worker->bottom, __ATOMIC_RELAXED);
+    LONG top = __atomic_load_n(&worker->top, __ATOMIC_ACQUIRE);
+
+    if ((DWORD)(bottom - top) >= worker->dequeCapacity) return FALSE;
+
+    worker->deque[(DWORD)bottom & (worker->dequeCapacity - 1)] = task;
+    __atomic_store_n(&worker->bottom, bottom + 1, __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+/*
+ * Pops a task at the owner end. Only the owning worker calls this.
+ * Races with thieves only for the last task, settled by a CAS on top.
+ */
+static PPICO_TASK DequePop(PPICO_WORKER worker) {
+    LONG bottom = __atomic_load_n(&worker->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&worker->bottom, bottom, __ATOMIC_SEQ_CST);
+    LONG top = __atomic_load_n(&worker->top, __ATOMIC_SEQ_CST);
+
+    if (bottom - top < 0) {
+        __atomic_store_n(&worker->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    PPICO_TASK task = worker->deque[(DWORD)bottom & (worker->dequeCapacity - 1)];
+    if (bottom != top) return task;
+
+    if (!__atomic_compare_exchange_n(&worker->top, &top, top + 1, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        task = NULL;
+    }
+
+    __atomic_store_n(&worker->bottom, bottom + 1, __ATOMIC_RELAXED);
+    return task;
+}
+
+/*
+ * Steals a task at the top end. Any thread may call this.
+ */
+static PPICO_TASK DequeSteal(PPICO_WORKER worker) {
+    LONG top = __atomic_load_n(&worker->top, __ATOMIC_SEQ_CST);
+    LONG bottom = __atomic_load_n(&worker->bottom, __ATOMIC_SEQ_CST);
+
+    if (bottom - top <= 0) return NULL;
+
+    PPICO_TASK task = worker->deque[(DWORD)top & (worker->dequeCapacity - 1)];
+    if (!__atomic_compare_exchange_n(&worker->top, &top, top + 1, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return NULL;
+    }
+
+    return task;
+}
+
+/* ========================================================================
+ * ENTRY HOLD FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Adds a task's hold on a module, unless the manager has claimed it.
+ */
+static BOOL HoldEntry(PPICO_ENTRY entry) {
+    LONG count = __atomic_load_n(&entry->activeTasks, __ATOMIC_RELAXED);
+
+    do {
+        if (count < 0) return FALSE;
+    } while (!__atomic_compare_exchange_n(&entry->activeTasks, &count, count + 1, TRUE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+
+    return TRUE;
+}
+
+/*
+ * Claims an entry with no tasks holding it.
+ */
+BOOL PicoEntryClaim(PPICO_ENTRY entry) {
+    LONG idle = 0;
+
+    if (!entry) return FALSE;
+
+    return __atomic_compare_exchange_n(&entry->activeTasks, &idle, PICO_TASKS_CLAIMED, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+/*
+ * Releases a claimed entry.
+ */
+void PicoEntryUnclaim(PPICO_ENTRY entry) {
+    if (entry) {
+        __atomic_store_n(&entry->activeTasks, 0, __ATOMIC_RELEASE);
+    }
+}
+
+/* ========================================================================
+ * WORKER FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Runs a task and releases its hold on the module.
+ */
+static void RunTask(PPICO_TASK task) {
+    char* function = task->function ? task->function : task->entry->entryPoint;
+
+    ((PICOMAIN_FUNC)function)(task->arg);
+
+    if (task->entry) {
+        InterlockedDecrement(&task->entry->activeTasks);
+    }
+    __atomic_store_n(&task->state, PICO_TASK_DONE, __ATOMIC_RELEASE);
+}
+
+/*
+ * Settles a task the stopped executor will never run.
+ */
+static void FailTask(PPICO_TASK task) {
+    if (task->entry) {
+        InterlockedDecrement(&task->entry->activeTasks);
+    }
+    __atomic_store_n(&task->state, PICO_TASK_FAILED, __ATOMIC_RELEASE);
+}
+
+/*
+ * Returns the worker running on the calling thread, or NULL.
+ */
+static PPICO_WORKER CurrentWorker(PPICO_EXECUTOR executor) {
+    DWORD threadId = KERNEL32$GetCurrentThreadId();
+
+    for (DWORD i = 0; i < executor->workerCount; i++) {
+        if (executor->workers[i].threadId == threadId) {
+            return &executor->workers[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Steals one task from any worker other than the given one.
+ */
+static PPICO_TASK StealTask(PPICO_EXECUTOR executor, PPICO_WORKER self) {
+    DWORD start = self ? (DWORD)(self - executor->workers) + 1 : 0;
+
+    for (DWORD i = 0; i < executor->workerCount; i++) {
+        PPICO_WORKER victim = &executor->workers[(start + i) % executor->workerCount];
+        if (victim == self) continue;
+
+        PPICO_TASK task = DequeSteal(victim);
+        if (task) return task;
+    }
+
+    return NULL;
+}
+
+/*
+ * Finds the next task for a worker: own deque, then its inbox, then other deques.
+ */
+static PPICO_TASK NextTask(PPICO_WORKER worker) {
+    PPICO_TASK task = DequePop(worker);
+    if (task) return task;
+
+    /* Move submitted tasks into the deque so idle workers can steal them */
+    PPICO_TASK batch[PICO_EXECUTOR_DRAIN];
+    DWORD count = PicoChannelReceive(worker->inbox, batch, PICO_EXECUTOR_DRAIN);
+    if (count > 0) {
+        for (DWORD i = 1; i < count; i++) {
+            if (!DequePush(worker, batch[i])) {
+                RunTask(batch[i]);
+            }
+        }
+        return batch[0];
+    }
+
+    return StealTask(worker->executor, worker);
+}
+
+/*
+ * Worker thread routine.
+ */
+static DWORD WINAPI WorkerThread(LPVOID param) {
+    PPICO_WORKER worker = (PPICO_WORKER)param;
+    PPICO_EXECUTOR executor = worker->executor;
+
+    /* CreateThread may publish the ID only after we are already running */
+    worker->threadId = KERNEL32$GetCurrentThreadId();
+
+    while (TRUE) {
+        PPICO_TASK task = NextTask(worker);
+        if (task) {
+            RunTask(task);
+            continue;
+        }
+
+        /* Queues are drained: exit if asked to, otherwise sleep until the next submission */
+        if (__atomic_load_n(&executor->stopping, __ATOMIC_ACQUIRE)) break;
+
+        KERNEL32$WaitForSingleObject(executor->wakeup, PICO_EXECUTOR_IDLE_WAIT);
+    }
+
+    return 0;
+}
+
+/* ========================================================================
+ * EXECUTOR FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Carves the executor, its workers and their deques out of the manager arena.
+ */
+static PPICO_EXECUTOR AllocExecutor(PPICO_MANAGER manager, DWORD workerCount, DWORD taskCapacity) {
+    PPICO_EXECUTOR executor = (PPICO_EXECUTOR)PicoManagerArenaAlloc(manager, sizeof(PICO_EXECUTOR), PICO_CACHE_LINE);
+    if (!executor) return NULL;
+
+    executor->workers = (PPICO_WORKER)PicoManagerArenaAlloc(manager, sizeof(PICO_WORKER) * workerCount, PICO_CACHE_LINE);
+    if (!executor->workers) return NULL;
+
+    for (DWORD i = 0; i < workerCount; i++) {
+        executor->workers[i].deque = (PPICO_TASK*)PicoManagerArenaAlloc(manager, sizeof(PPICO_TASK) * taskCapacity, PICO_CACHE_LINE);
+        if (!executor->workers[i].deque) return NULL;
+    }
+
+    executor->workerCapacity = workerCount;
+    executor->taskCapacity = taskCapacity;
+    return executor;
+}
+
+/*
+ * Starts the executor with workers carved out of the manager arena, or
+ * those of an earlier start.
+ */
+BOOL PicoExecutorStart(PPICO_MANAGER manager, DWORD workerCount, DWORD taskCapacity) {
+    if (!manager || manager->executor) return FALSE;
+    if (workerCount == 0 || taskCapacity < 2 || (taskCapacity & (taskCapacity - 1))) return FALSE;
+
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_EXECUTOR);
+
+    /* The arena only grows, so a restart runs in the state of the first start */
+    PPICO_EXECUTOR executor = manager->executorState;
+    if (executor && (workerCount > executor->workerCapacity || taskCapacity > executor->taskCapacity)) return PicoStatsLeave(&manager->stats, operation, FALSE);
+    if (!executor) {
+        executor = AllocExecutor(manager, workerCount, taskCapacity);
+        if (!executor) return PicoStatsLeave(&manager->stats, operation, FALSE);
+        manager->executorState = executor;
+    }
+
+    executor->workerCount = workerCount;
+    executor->stopping = 0;
+    executor->submitting = 0;
+    executor->nextWorker = 0;
+
+    for (DWORD i = 0; i < workerCount; i++) {
+        PPICO_WORKER worker = &executor->workers[i];
+
+        /* Inbox name: "executor" followed by the worker index */
+        char name[PICO_NAME_MAX_LENGTH] = "executor";
+        char digits[10];
+        DWORD length = 8;
+        DWORD count = 0;
+        DWORD value = i;
+        do {
+            digits[count++] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value);
+        while (count) {
+            name[length++] = digits[--count];
+        }
+        name[length] = '\0';
+
+        worker->executor = executor;
+        worker->thread = NULL;
+        worker->threadId = 0;
+        worker->dequeCapacity = taskCapacity;
+        worker->top = 0;
+        worker->bottom = 0;
+        /* A restarted executor picks up the inboxes of the previous one */
+        worker->inbox = GetPicoChannel(manager, name);
+        if (!worker->inbox) {
+            worker->inbox = CreatePicoChannel(manager, name, PICO_CHANNEL_MPSC, sizeof(PPICO_TASK), taskCapacity);
+        }
+        if (!worker->inbox) return PicoStatsLeave(&manager->stats, operation, FALSE);
+    }
+
+    DWORD64 start = PicoStatsStart(&manager->stats);
+    executor->wakeup = KERNEL32$CreateSemaphoreA(NULL, 0, 0x7FFFFFFF, NULL);
+    PicoStatsStop(&manager->stats, PICO_CALL_THREAD, start);
+    if (!executor->wakeup) return PicoStatsLeave(&manager->stats, operation, FALSE);
+
+    /* Publish before starting workers so they can see the executor */
+    manager->executor = executor;
+
+    for (DWORD i = 0; i < workerCount; i++) {
+        PPICO_WORKER worker = &executor->workers[i];
+
+        start = PicoStatsStart(&manager->stats);
+        worker->thread = KERNEL32$CreateThread(NULL, 0, WorkerThread, worker, 0, &worker->threadId);
+        PicoStatsStop(&manager->stats, PICO_CALL_THREAD, start);
+        if (!worker->thread) {
+            /* Run with the workers we have; stop them if there are none */
+            executor->workerCount = i;
+            if (i == 0) {
+                KERNEL32$CloseHandle(executor->wakeup);
+                manager->executor = NULL;
+                return PicoStatsLeave(&manager->stats, operation, FALSE);
+            }
+            break;
+        }
+    }
+
+    return PicoStatsLeave(&manager->stats, operation, TRUE);
+}
+
+/*
+ * Stops the executor after the queues are drained and joins all workers.
+ */
+BOOL PicoExecutorStop(PPICO_MANAGER manager) {
+    if (!manager || !manager->executor) return FALSE;
+
+    PPICO_EXECUTOR executor = manager->executor;
+
+    /* New submissions are refused from here; wait out those already past the check */
+    __atomic_store_n(&executor->stopping, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&executor->submitting, __ATOMIC_SEQ_CST)) {
+        KERNEL32$SwitchToThread();
+    }
+    KERNEL32$ReleaseSemaphore(executor->wakeup, (LONG)executor->workerCount, NULL);
+
+    for (DWORD i = 0; i < executor->workerCount; i++) {
+        KERNEL32$WaitForSingleObject(executor->workers[i].thread, INFINITE);
+        KERNEL32$CloseHandle(executor->workers[i].thread);
+    }
+
+    /* Workers leave empty queues; anything still queued lost its race with the stop */
+    for (DWORD i = 0; i < executor->workerCount; i++) {
+        PPICO_WORKER worker = &executor->workers[i];
+        PPICO_TASK task;
+
+        while ((task = DequeSteal(worker)) != NULL) {
+            FailTask(task);
+        }
+        while (PicoChannelReceive(worker->inbox, &task, 1)) {
+            FailTask(task);
+        }
+    }
+
+    KERNEL32$CloseHandle(executor->wakeup);
+    __atomic_store_n(&manager->executor, NULL, __ATOMIC_RELEASE);
+
+    return TRUE;
+}
+
+/*
+ * Submits a task. Workers push onto their own deque; other threads go
+ * through a worker inbox picked round-robin. Full queues run the task inline.
+ */
+BOOL SubmitPicoTask(PPICO_MANAGER manager, PPICO_TASK task) {
+    if (!manager || !task) return FALSE;
+    if (task->entry ? (!task->function && !task->entry->entryPoint) : !task->function) return FALSE;
+
+    PPICO_EXECUTOR executor = __atomic_load_n(&manager->executor, __ATOMIC_ACQUIRE);
+    if (!executor) return FALSE;
+
+    /* Checked and counted against PicoExecutorStop, which waits for submissions in progress */
+    InterlockedIncrement(&executor->submitting);
+    if (__atomic_load_n(&executor->stopping, __ATOMIC_SEQ_CST)) {
+        InterlockedDecrement(&executor->submitting);
+        return FALSE;
+    }
+
+    /* The hold goes before the code check: a claimed entry may be unloading */
+    if (task->entry && !HoldEntry(task->entry)) {
+        InterlockedDecrement(&executor->submitting);
+        return FALSE;
+    }
+    if (task->entry && !task->entry->code) {
+        InterlockedDecrement(&task->entry->activeTasks);
+        InterlockedDecrement(&executor->submitting);
+        return FALSE;
+    }
+
+    task->state = PICO_TASK_PENDING;
+
+    PPICO_WORKER self = CurrentWorker(executor);
+    if (self) {
+        if (!DequePush(self, task)) {
+            RunTask(task);
+        }
+        InterlockedDecrement(&executor->submitting);
+        return TRUE;
+    }
+
+    LONG start = InterlockedIncrement(&executor->nextWorker);
+    for (DWORD i = 0; i < executor->workerCount; i++) {
+        PPICO_WORKER worker = &executor->workers[((DWORD)start + i) % executor->workerCount];
+
+        if (PicoChannelSend(worker->inbox, &task, 1)) {
+            KERNEL32$ReleaseSemaphore(executor->wakeup, 1, NULL);
+            InterlockedDecrement(&executor->submitting);
+            return TRUE;
+        }
+    }
+
+    InterlockedDecrement(&executor->submitting);
+    RunTask(task);
+    return TRUE;
+}
+
+/*
+ * Waits for a task, helping with queued work in the meantime.
+ */
+BOOL WaitPicoTask(PPICO_MANAGER manager, PPICO_TASK task) {
+    if (!manager || !task) return FALSE;
+
+    while (__atomic_load_n(&task->state, __ATOMIC_ACQUIRE) == PICO_TASK_PENDING) {
+        PPICO_EXECUTOR executor = __atomic_load_n(&manager->executor, __ATOMIC_ACQUIRE);
+
+        /* A stop settles every queued task before the executor goes; nothing is left to finish this one */
+        if (!executor) break;
+
+        PPICO_WORKER self = CurrentWorker(executor);
+        PPICO_TASK other = self ? NextTask(self) : StealTask(executor, NULL);
+
+        if (other) {
+            RunTask(other);
+        } else {
+            KERNEL32$SwitchToThread();
+        }
+    }
+
+    return __atomic_load_n(&task->state, __ATOMIC_ACQUIRE) == PICO_TASK_DONE;
+}
@@ -0,0 +1,69 @@
+/*
+ * PICO Manager Library - Internal interfaces
+ *
+ * Shared by the library's translation units and the loader harness, not
+ * part of the public API: memory dispatch, call statistics and the loader's
+ * split-load entry points.
+ */
+
+#ifndef PICO_INTERNAL_H
+#define PICO_INTERNAL_H
+
+#include "../Include/PicoManager.h"
+
+/* Loader phases for PicoLoadPart, run in this order */
+#define PICO_LOAD_COPY    0x0               /* Copy directives, split by bytes */
+#define PICO_LOAD_PATCH   0x1               /* PATCH and PATCH_DIFF directives, split by count */
+#define PICO_LOAD_IMPORTS 0x2               /* LL, GPA and PATCH_FUNC directives, never split */
+
+/*
+ * Loader part range
+ * One part's share of a loader phase, cut by PicoLoadSplit: the directive
+ * it starts at, with the walk state needed to resume there, and the units
+ * (copy bytes or patch directives) it covers.
+ */
+typedef struct _PICO_LOAD_RANGE {
+    char* next;                             /* Stream position of the first directive (NULL if the share is empty) */
+    int remaining;                          /* Compact vaults: items left in the current record */
+    int type;                               /* Compact vaults: type, option and running offset of that record */
+    int option;
+    int offset;
+    long long position;                     /* Units of the phase before the first directive */
+    long long first;                        /* First unit of the share */
+    long long last;                         /* One past the last unit of the share */
+} PICO_LOAD_RANGE, *PPICO_LOAD_RANGE;
+
+/*
+ * Split loading: size the copy and patch phases, cut them into per-part ranges, run one part
+ */
+int PicoCopySize(char * src);
+BOOL PicoSplitCount(char * src, int * copyBytes, int * patches);
+void PicoLoadSplit(char * src, int copyBytes, int patches, int parts, PICO_LOAD_RANGE * ranges);
+void PicoLoadPart(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData, int phase, PICO_LOAD_RANGE * range);
+
+/*
+ * Memory dispatch: the allocator's callbacks, or VirtualAlloc/VirtualFree if NULL.
+ * Calls are counted in stats unless it is NULL.
+ */
+char* PicoMemoryReserve(PPICO_ALLOCATOR allocator, PPICO_STATS stats, SIZE_T size, DWORD protect, DWORD kind);
+char* PicoMemoryReserveLarge(PPICO_ALLOCATOR allocator, PPICO_STATS stats, SIZE_T* size, DWORD protect, DWORD kind, SIZE_T* pageSize);
+BOOL PicoMemoryCommit(PPICO_ALLOCATOR allocator, PPICO_STATS stats, char* address, SIZE_T size, DWORD protect, DWORD kind);
+BOOL PicoMemoryDecommit(PPICO_ALLOCATOR allocator, PPICO_STATS stats, char* address, SIZE_T size, DWORD kind);
+BOOL PicoMemoryRelease(PPICO_ALLOCATOR allocator, PPICO_STATS stats, char* address, SIZE_T size, DWORD kind);
+
+/*
+ * Call statistics: counts the call and, with timing on, the ticks since start (stats may be NULL)
+ */
+DWORD64 PicoStatsStart(PPICO_STATS stats);
+void PicoStatsStop(PPICO_STATS stats, DWORD call, DWORD64 start);
+void PicoStatsAdd(PPICO_STATS stats, DWORD call, DWORD count);
+
+/*
+ * Operation scope: Enter attributes the calls that follow to an operation and
+ * returns the previous one; Leave puts it back and passes the result through
+ * (stats may be NULL)
+ */
+DWORD PicoStatsEnter(PPICO_STATS stats, DWORD operation);
+BOOL PicoStatsLeave(PPICO_STATS stats, DWORD previous, BOOL result);
+
+#endif /* PICO_INTERNAL_H */
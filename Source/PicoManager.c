@@ -7,17 +7,38 @@
 
 #include <windows.h>
 #include "../Include/PicoManager.h"
+#include "PicoInternal.h"
+#include "../Include/PicoFormat.h"
+
+/* Vaults read back from checkpoints are walked within their recorded size */
+#define PICO_CURSOR_CHECKED
+#include "../Include/PicoCursor.h"
 
 /* ========================================================================
  * EXTERNAL FUNCTION DECLARATIONS
  * ======================================================================== */
 
 DECLSPEC_IMPORT void* __cdecl MSVCRT$memset(void* dest, int c, size_t count);
-DECLSPEC_IMPORT size_t __cdecl MSVCRT$strlen(const char* str);
 DECLSPEC_IMPORT int __cdecl MSVCRT$strncmp(const char* str1, const char* str2, size_t count);
 DECLSPEC_IMPORT char* __cdecl MSVCRT$strncpy(char* dest, const char* src, size_t count);
-WINBASEAPI LPVOID WINAPI KERNEL32$VirtualAlloc(LPVOID lpAddress, SIZE_T dwSize, DWORD flAllocationType, DWORD flProtect);
-WINBASEAPI BOOL WINAPI KERNEL32$VirtualFree(LPVOID lpAddress, SIZE_T dwSize, DWORD dwFreeType);
+WINBASEAPI HANDLE WINAPI KERNEL32$CreateThread(LPSECURITY_ATTRIBUTES lpThreadAttributes, SIZE_T dwStackSize, LPTHREAD_START_ROUTINE lpStartAddress, LPVOID lpParameter, DWORD dwCreationFlags, LPDWORD lpThreadId);
+WINBASEAPI DWORD WINAPI KERNEL32$WaitForMultipleObjects(DWORD nCount, const HANDLE* lpHandles, BOOL bWaitAll, DWORD dwMilliseconds);
+WINBASEAPI BOOL WINAPI KERNEL32$CloseHandle(HANDLE hObject);
+
+/* ========================================================================
+ * INTERNAL FUNCTION DECLARATIONS
+ * ======================================================================== */
+
+#define BOOTSTRAP_ALIGN(x, a) (((SIZE_T)(x) + (a) - 1) & ~(SIZE_T)((a) - 1))
+
+/* Data slots in a reservation are whole pages, so each can be decommitted on its own */
+#define DATA_SLOT_SIZE(x) BOOTSTRAP_ALIGN((x), PICO_PAGE_SIZE)
+
+static BOOL UnloadEntry(PPICO_MANAGER manager, PPICO_ENTRY entry, BOOL decommit);
+static void ReleaseData(PPICO_MANAGER manager, PPICO_ENTRY entry);
+static void TouchPages(char* start, SIZE_T size);
+static DWORD NameIndexHome(PPICO_MANAGER manager, DWORD hash);
+static void NameIndexInsert(PPICO_MANAGER manager, PPICO_ENTRY entry);
 
 /* ========================================================================
  * INITIALIZATION FUNCTIONS
@@ -33,11 +54,49 @@ void PicoManagerInit(PPICO_MANAGER manager, PPICO_ENTRY entries, DWORD entryCapa
     
     manager->baseAddress = NULL;
     manager->blockSize = 0;
+    manager->reserveSize = 0;
     manager->usedSize = 0;
     manager->entries = entries;
     manager->entryCount = 0;
     manager->entryCapacity = entryCapacity;
     manager->interPicoPadding = 0;
+    manager->exportSlots = NULL;
+    manager->exportCapacity = 0;
+    manager->exportCount = 0;
+    manager->exportOverflow = FALSE;
+    manager->nameSlots = NULL;
+    manager->nameCapacity = 0;
+    manager->boundExports = NULL;
+    manager->boundCount = 0;
+    manager->arenaBase = NULL;
+    manager->arenaSize = 0;
+    manager->arenaUsed = 0;
+    manager->channels = NULL;
+    manager->executor = NULL;
+    manager->executorState = NULL;
+    manager->dataArenaBase = NULL;
+    manager->dataArenaSize = 0;
+    manager->dataArenaUsed = 0;
+    manager->codeBudget = 0;
+    manager->dataBudget = 0;
+    manager->residentCode = 0;
+    manager->residentData = 0;
+    manager->useClock = 0;
+    manager->funcs = NULL;
+    manager->finalPadding = 0;
+    manager->vaultCache = NULL;
+    manager->verifyEntry = 0;
+    manager->verifyOffset = 0;
+    manager->verifyCrc = 0;
+    manager->crcSupport = PICO_CRC_UNKNOWN;
+    manager->allocator = NULL;
+    manager->bootstrapBase = NULL;
+    manager->bootstrapSize = 0;
+    MSVCRT$memset(&manager->stats, 0, sizeof(PICO_STATS));
+    manager->blockOptions = 0;
+    manager->largePageSize = 0;
+    manager->loadParts = 0;
+    manager->loadThreshold = 0;
 }
 
 /*
@@ -53,13 +112,26 @@ BOOL AddPico(PPICO_MANAGER manager, const char* name, char* vault) {
     entry->id = manager->entryCount;
     MSVCRT$strncpy(entry->name, name, PICO_NAME_MAX_LENGTH - 1);
     entry->name[PICO_NAME_MAX_LENGTH - 1] = '\0';
+    entry->nameHash = PicoNameHash(entry->name);
+    
+    /* Identical vault contents share one parse through the cache */
+    entry->info = PicoVaultCacheLookup(manager->vaultCache, vault);
     
     entry->code = NULL;
-    entry->codeSize = PicoCodeSize(vault);
+    entry->codeSize = entry->info ? entry->info->codeSize : PicoCodeSize(vault);
     entry->data = NULL;
-    entry->dataSize = PicoDataSize(vault);
+    entry->dataSize = entry->info ? entry->info->dataSize : PicoDataSize(vault);
     entry->entryPoint = NULL;
     entry->vault = vault;
+    entry->dependencies = 0;
+    entry->flags = 0;
+    entry->activeTasks = 0;
+    entry->lastUse = 0;
+    entry->imports = NULL;
+    entry->codeCrc = 0;
+    entry->dataSlot = NULL;
+    
+    NameIndexInsert(manager, entry);
     
     manager->entryCount++;
     return TRUE;
@@ -77,6 +149,55 @@ PPICO_ENTRY GetPicoById(PPICO_MANAGER manager, DWORD id) {
     return &manager->entries[id];
 }
 
+/*
+ * Hashes a module name with FNV-1a, up to the length AddPico keeps.
+ */
+DWORD PicoNameHash(const char* name) {
+    DWORD hash = PICO_NAME_HASH_BASIS;
+    
+    for (SIZE_T i = 0; i < PICO_NAME_MAX_LENGTH - 1 && name[i]; i++) {
+        hash = (hash ^ (unsigned char)name[i]) * PICO_NAME_HASH_PRIME;
+    }
+    
+    return hash;
+}
+
+/*
+ * Compares a stored name with a lookup name, which counts only as far as
+ * AddPico keeps names.
+ */
+static BOOL NameMatches(PPICO_ENTRY entry, DWORD hash, const char* name) {
+    return entry->nameHash == hash && MSVCRT$strncmp(entry->name, name, PICO_NAME_MAX_LENGTH - 1) == 0;
+}
+
+/*
+ * Retrieves a PICO entry by the hash of its name.
+ * Probes the name index and compares the name of hash matches only; scans
+ * the entries when the index is disabled.
+ */
+PPICO_ENTRY GetPicoByHash(PPICO_MANAGER manager, DWORD hash, const char* name) {
+    if (!manager || !name) return NULL;
+    
+    if (manager->nameSlots) {
+        DWORD mask = manager->nameCapacity - 1;
+        
+        for (DWORD i = NameIndexHome(manager, hash); manager->nameSlots[i]; i = (i + 1) & mask) {
+            PPICO_ENTRY entry = &manager->entries[manager->nameSlots[i] - 1];
+            if (NameMatches(entry, hash, name)) return entry;
+        }
+        
+        return NULL;
+    }
+    
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        if (NameMatches(&manager->entries[i], hash, name)) {
+            return &manager->entries[i];
+        }
+    }
+    
+    return NULL;
+}
+
 /*
  * Retrieves a PICO entry by its name.
  * Performs case-sensitive string comparison.
@@ -84,15 +205,253 @@ PPICO_ENTRY GetPicoById(PPICO_MANAGER manager, DWORD id) {
 PPICO_ENTRY GetPicoByName(PPICO_MANAGER manager, const char* name) {
     if (!manager || !name) return NULL;
     
-    SIZE_T nameLen = MSVCRT$strlen(name);
-    if (nameLen >= PICO_NAME_MAX_LENGTH) {
-        nameLen = PICO_NAME_MAX_LENGTH - 1;
+    return GetPicoByHash(manager, PicoNameHash(name), name);
+}
+
+/* ========================================================================
+ * NAME INDEX FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Home slot of a name hash in the name index.
+ */
+static DWORD NameIndexHome(PPICO_MANAGER manager, DWORD hash) {
+    return (hash ^ (hash >> 16)) & (manager->nameCapacity - 1);
+}
+
+/*
+ * Indexes an entry by its name hash. Entries go in by ID, so the first match
+ * along a probe sequence is the lowest ID, as in a scan.
+ */
+static void NameIndexInsert(PPICO_MANAGER manager, PPICO_ENTRY entry) {
+    if (!manager->nameSlots) return;
+    
+    DWORD mask = manager->nameCapacity - 1;
+    DWORD i = NameIndexHome(manager, entry->nameHash);
+    
+    while (manager->nameSlots[i]) {
+        i = (i + 1) & mask;
     }
+    manager->nameSlots[i] = entry->id + 1;
+}
+
+/*
+ * Clears the name index and indexes every registered entry again.
+ */
+static void NameIndexRebuild(PPICO_MANAGER manager) {
+    if (!manager->nameSlots) return;
+    
+    MSVCRT$memset(manager->nameSlots, 0, sizeof(DWORD) * manager->nameCapacity);
     
     for (DWORD i = 0; i < manager->entryCount; i++) {
-        if (MSVCRT$strncmp(manager->entries[i].name, name, nameLen) == 0 && 
-            manager->entries[i].name[nameLen] == '\0') {
-            return &manager->entries[i];
+        NameIndexInsert(manager, &manager->entries[i]);
+    }
+}
+
+/*
+ * Enables the name index and indexes all PICOs that are already registered.
+ */
+BOOL PicoManagerInitNames(PPICO_MANAGER manager, DWORD* slots, DWORD slotCapacity) {
+    if (!manager || !slots || slotCapacity < 2) return FALSE;
+    if (slotCapacity & (slotCapacity - 1)) return FALSE;
+    
+    /* A free slot must remain with the entry table full, so probe sequences end */
+    if (slotCapacity <= manager->entryCapacity) return FALSE;
+    
+    manager->nameSlots = slots;
+    manager->nameCapacity = slotCapacity;
+    NameIndexRebuild(manager);
+    
+    return TRUE;
+}
+
+/* ========================================================================
+ * EXPORT REGISTRY FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Home slot of a tag in the export registry (Fibonacci hashing).
+ */
+static DWORD ExportRegistryHome(PPICO_MANAGER manager, int tag) {
+    DWORD hash = (DWORD)tag * 0x9E3779B1;
+    return (hash ^ (hash >> 16)) & (manager->exportCapacity - 1);
+}
+
+/*
+ * Finds the registry slot of a tag, optionally restricted to one module.
+ * Returns NULL if not present.
+ */
+static PPICO_EXPORT_SLOT ExportRegistryFind(PPICO_MANAGER manager, int tag, PPICO_ENTRY entry) {
+    DWORD mask = manager->exportCapacity - 1;
+    
+    for (DWORD i = ExportRegistryHome(manager, tag); manager->exportSlots[i].entry; i = (i + 1) & mask) {
+        PPICO_EXPORT_SLOT slot = &manager->exportSlots[i];
+        if (slot->tag == tag && (!entry || slot->entry == entry)) {
+            return slot;
+        }
+    }
+    
+    return NULL;
+}
+
+/*
+ * Fills (loaded) or clears the bound export slots an entry provides.
+ */
+static void BoundExportsUpdate(PPICO_MANAGER manager, PPICO_ENTRY entry, BOOL loaded) {
+    for (DWORD i = 0; i < manager->boundCount; i++) {
+        PPICO_BOUND_EXPORT bound = &manager->boundExports[i];
+        if (bound->id != entry->id) continue;
+        
+        bound->address = loaded ? (char*)PicoGetExport(entry->vault, entry->code, bound->tag) : NULL;
+    }
+}
+
+/*
+ * Publishes all exports of a freshly loaded PICO in the registry and its bound slots.
+ * Linear probing keeps modules sharing a tag in load order along the probe sequence.
+ */
+static void ExportRegistryInsert(PPICO_MANAGER manager, PPICO_ENTRY entry) {
+    BoundExportsUpdate(manager, entry, TRUE);
+    if (!manager->exportSlots) return;
+    
+    DWORD mask = manager->exportCapacity - 1;
+    PPICO_VAULT_EXPORT index = entry->info ? entry->info->exports : NULL;
+    DWORD next = 0;
+    char* cursor = NULL;
+    int tag;
+    int offset;
+    
+    while (TRUE) {
+        /* Walk the cached export index when there is one, the vault otherwise */
+        if (index) {
+            if (next >= entry->info->exportCount) break;
+            tag = index[next].tag;
+            offset = index[next].offset;
+            next++;
+        } else if ((cursor = PicoNextExport(entry->vault, cursor, &tag, &offset)) == NULL) {
+            break;
+        }
+        
+        /* Always keep one free slot so probe sequences terminate */
+        if (manager->exportCount + 1 >= manager->exportCapacity) {
+            manager->exportOverflow = TRUE;
+            return;
+        }
+        
+        DWORD i = ExportRegistryHome(manager, tag);
+        while (manager->exportSlots[i].entry) {
+            i = (i + 1) & mask;
+        }
+        
+        manager->exportSlots[i].entry = entry;
+        manager->exportSlots[i].address = entry->code + offset;
+        manager->exportSlots[i].tag = tag;
+        manager->exportCount++;
+    }
+}
+
+/*
+ * Withdraws all exports of a PICO from the registry and its bound slots.
+ * Uses backward-shift deletion so no tombstones are left behind.
+ */
+static void ExportRegistryRemove(PPICO_MANAGER manager, PPICO_ENTRY entry) {
+    BoundExportsUpdate(manager, entry, FALSE);
+    if (!manager->exportSlots) return;
+    
+    DWORD mask = manager->exportCapacity - 1;
+    
+    for (DWORD i = 0; i < manager->exportCapacity; i++) {
+        while (manager->exportSlots[i].entry == entry) {
+            DWORD hole = i;
+            DWORD j = i;
+            
+            /* Pull later members of the cluster back into the hole when their home allows it */
+            while (TRUE) {
+                manager->exportSlots[hole].entry = NULL;
+                
+                while (TRUE) {
+                    j = (j + 1) & mask;
+                    if (!manager->exportSlots[j].entry) break;
+                    
+                    DWORD home = ExportRegistryHome(manager, manager->exportSlots[j].tag);
+                    BOOL pinned = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+                    if (!pinned) break;
+                }
+                
+                if (!manager->exportSlots[j].entry) break;
+                
+                manager->exportSlots[hole] = manager->exportSlots[j];
+                hole = j;
+            }
+            
+            manager->exportCount--;
+        }
+    }
+}
+
+/*
+ * Enables the export registry and indexes all PICOs that are already loaded.
+ */
+BOOL PicoManagerInitExports(PPICO_MANAGER manager, PPICO_EXPORT_SLOT slots, DWORD slotCapacity) {
+    if (!manager || !slots || slotCapacity < 2) return FALSE;
+    if (slotCapacity & (slotCapacity - 1)) return FALSE;
+    
+    MSVCRT$memset(slots, 0, sizeof(PICO_EXPORT_SLOT) * slotCapacity);
+    
+    manager->exportSlots = slots;
+    manager->exportCapacity = slotCapacity;
+    manager->exportCount = 0;
+    manager->exportOverflow = FALSE;
+    
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        if (manager->entries[i].code) {
+            ExportRegistryInsert(manager, &manager->entries[i]);
+        }
+    }
+    
+    return TRUE;
+}
+
+/*
+ * Binds export slots to fixed modules and fills those already loaded.
+ */
+BOOL PicoManagerBindExports(PPICO_MANAGER manager, PPICO_BOUND_EXPORT exports, DWORD count) {
+    if (!manager || (!exports && count)) return FALSE;
+    
+    manager->boundExports = exports;
+    manager->boundCount = count;
+    
+    for (DWORD i = 0; i < count; i++) {
+        PPICO_ENTRY entry = GetPicoById(manager, exports[i].id);
+        exports[i].address = (entry && entry->code) ? (char*)PicoGetExport(entry->vault, entry->code, exports[i].tag) : NULL;
+    }
+    
+    return TRUE;
+}
+
+/*
+ * Retrieves an export by tag from any loaded PICO.
+ * Falls back to scanning loaded modules when the registry is disabled or overflowed.
+ */
+char* GetPicoExport(PPICO_MANAGER manager, int tag, PPICO_ENTRY* provider) {
+    if (!manager) return NULL;
+    
+    if (manager->exportSlots && !manager->exportOverflow) {
+        PPICO_EXPORT_SLOT slot = ExportRegistryFind(manager, tag, NULL);
+        if (!slot) return NULL;
+        
+        if (provider) *provider = slot->entry;
+        return slot->address;
+    }
+    
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
+        if (!entry->vault || !entry->code) continue;
+        
+        char* address = (char*)PicoGetExport(entry->vault, entry->code, tag);
+        if (address) {
+            if (provider) *provider = entry;
+            return address;
         }
     }
     
@@ -103,6 +462,30 @@ PPICO_ENTRY GetPicoByName(PPICO_MANAGER manager, const char* name) {
  * REMOVAL FUNCTIONS
  * ======================================================================== */
 
+/*
+ * Releases the claims on entries [first, last).
+ */
+static void UnclaimEntries(PPICO_MANAGER manager, DWORD first, DWORD last) {
+    for (DWORD i = first; i < last; i++) {
+        PicoEntryUnclaim(&manager->entries[i]);
+    }
+}
+
+/*
+ * Claims entries [first, last) so no executor task can start on them,
+ * or none if any is in use.
+ */
+static BOOL ClaimEntries(PPICO_MANAGER manager, DWORD first, DWORD last) {
+    for (DWORD i = first; i < last; i++) {
+        if (!PicoEntryClaim(&manager->entries[i])) {
+            UnclaimEntries(manager, first, i);
+            return FALSE;
+        }
+    }
+    
+    return TRUE;
+}
+
 /*
  * Removes a PICO entry by ID.
  * Frees allocated memory and compacts the array by removing the entry.
@@ -112,14 +495,35 @@ PPICO_ENTRY GetPicoByName(PPICO_MANAGER manager, const char* name) {
 BOOL RemovePicoById(PPICO_MANAGER manager, DWORD id) {
     if (!manager || id >= manager->entryCount) return FALSE;
     
+    /* Bound slots name fixed entry IDs that a shift would silently retarget */
+    if (manager->boundCount) return FALSE;
+    
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_REMOVE);
+    
     PPICO_ENTRY entry = &manager->entries[id];
     
+    /* Tasks hold entry pointers, so neither this entry nor any shifted one may be in use */
+    if (!ClaimEntries(manager, id, manager->entryCount)) return PicoStatsLeave(&manager->stats, operation, FALSE);
+    
+    /* Withdraw its exports before the entry goes away */
+    ExportRegistryRemove(manager, entry);
+    
+    /* Entries shift under the integrity scan, restart the module it is in */
+    manager->verifyOffset = 0;
+    
     /* Free data section (each PICO has its own RW block) */
     if (entry->data) {
-        KERNEL32$VirtualFree(entry->data, 0, MEM_RELEASE);
-        entry->data = NULL;
+        ReleaseData(manager, entry);
+        manager->residentData -= entry->dataSize;
     }
     
+    if (entry->code) {
+        manager->residentCode -= entry->codeSize;
+    }
+    
+    /* Drop its vault cache reference; a stored vault goes with the last one */
+    PicoVaultRelease(entry->info);
+    
     /* Shift all subsequent entries left to compact the array */
     for (DWORD i = id; i < manager->entryCount - 1; i++) {
         manager->entries[i] = manager->entries[i + 1];
@@ -133,7 +537,30 @@ BOOL RemovePicoById(PPICO_MANAGER manager, DWORD id) {
     /* Decrement count */
     manager->entryCount--;
     
-    return TRUE;
+    /* The claims moved along with the shifted entries */
+    UnclaimEntries(manager, id, manager->entryCount);
+    
+    /* Dependency masks follow the renumbering: drop the removed bit, shift higher bits down */
+    for (DWORD i = 0; i < manager->entryCount && id < PICO_SCHEDULE_MAX; i++) {
+        DWORD64 mask = manager->entries[i].dependencies;
+        DWORD64 low = mask & ((((DWORD64)1) << id) - 1);
+        DWORD64 high = (id + 1 < PICO_SCHEDULE_MAX) ? (mask >> (id + 1)) << id : 0;
+        manager->entries[i].dependencies = low | high;
+    }
+    
+    /* Registry slots of shifted entries follow them one position left */
+    if (manager->exportSlots) {
+        for (DWORD i = 0; i < manager->exportCapacity; i++) {
+            if (manager->exportSlots[i].entry > entry) {
+                manager->exportSlots[i].entry--;
+            }
+        }
+    }
+    
+    /* Shifted entries changed IDs, so their name slots do too */
+    NameIndexRebuild(manager);
+    
+    return PicoStatsLeave(&manager->stats, operation, TRUE);
 }
 
 /*
@@ -153,10 +580,87 @@ BOOL RemovePicoByName(PPICO_MANAGER manager, const char* name) {
     return RemovePicoById(manager, id);
 }
 
+/*
+ * Unloads a PICO by ID without unregistering it.
+ * Releases its code pages and data section; entry, name, vault and ID stay.
+ */
+BOOL UnloadPicoById(PPICO_MANAGER manager, DWORD id) {
+    if (!manager || id >= manager->entryCount) return FALSE;
+    
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_UNLOAD);
+    return PicoStatsLeave(&manager->stats, operation, UnloadEntry(manager, &manager->entries[id], TRUE));
+}
+
+/*
+ * Unloads a PICO by name without unregistering it.
+ */
+BOOL UnloadPicoByName(PPICO_MANAGER manager, const char* name) {
+    if (!manager || !name) return FALSE;
+    
+    PPICO_ENTRY entry = GetPicoByName(manager, name);
+    if (!entry) return FALSE;
+    
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_UNLOAD);
+    return PicoStatsLeave(&manager->stats, operation, UnloadEntry(manager, entry, TRUE));
+}
+
 /* ========================================================================
  * ALLOCATION AND LOADING FUNCTIONS
  * ======================================================================== */
 
+/*
+ * Reserves and commits the RWX code block, with large pages if the manager
+ * asks for them. *size may grow to a whole number of large pages.
+ * With normal pages, dataSize bytes of data slots follow the page-aligned
+ * block in the same reservation, returned in *data (NULL if there are none),
+ * so every data section is within 32-bit reach of the code. Slots are only
+ * reserved: PlacePico commits a slot when its PICO is loaded.
+ * A large-page reservation cannot hold normal read-write pages, so with
+ * large pages there are no slots and data is allocated per load.
+ */
+static char* ReserveCodeBlock(PPICO_MANAGER manager, SIZE_T* size, SIZE_T dataSize, char** data) {
+    *data = NULL;
+    
+    if (manager->blockOptions & PICO_BLOCK_LARGE_PAGES) {
+        char* block = PicoMemoryReserveLarge(manager->allocator, &manager->stats, size, PAGE_EXECUTE_READWRITE, PICO_MEMORY_CODE, &manager->largePageSize);
+        manager->reserveSize = *size;
+        return block;
+    }
+    
+    manager->largePageSize = 0;
+    
+    if (dataSize == 0) {
+        manager->reserveSize = *size;
+        return PicoMemoryReserve(manager->allocator, &manager->stats, *size, PAGE_EXECUTE_READWRITE, PICO_MEMORY_CODE);
+    }
+    
+    SIZE_T codeRegion = BOOTSTRAP_ALIGN(*size, PICO_PAGE_SIZE);
+    SIZE_T totalSize = codeRegion + BOOTSTRAP_ALIGN(dataSize, PICO_PAGE_SIZE);
+    
+    char* base = PicoMemoryReserve(manager->allocator, &manager->stats, totalSize, 0, PICO_MEMORY_CODE);
+    if (!base) {
+        return NULL;
+    }
+    
+    if (!PicoMemoryCommit(manager->allocator, &manager->stats, base, codeRegion, PAGE_EXECUTE_READWRITE, PICO_MEMORY_CODE)) {
+        PicoMemoryRelease(manager->allocator, &manager->stats, base, totalSize, PICO_MEMORY_CODE);
+        return NULL;
+    }
+    
+    *size = codeRegion;
+    *data = base + codeRegion;
+    manager->reserveSize = totalSize;
+    return base;
+}
+
+/*
+ * Size of the reservation holding the code block: code block alone if the
+ * caller assigned it, co-located data slots included otherwise.
+ */
+static SIZE_T CodeReservationSize(PPICO_MANAGER manager) {
+    return manager->reserveSize ? manager->reserveSize : manager->blockSize;
+}
+
 /*
  * Allocates the shared RWX memory block for storing PICO code sections.
  * Calculates required size based on registered PICOs and padding.
@@ -164,6 +668,8 @@ BOOL RemovePicoByName(PPICO_MANAGER manager, const char* name) {
 BOOL PicoManagerAlloc(PPICO_MANAGER manager, SIZE_T finalPadding) {
     if (!manager) return FALSE;
     
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_ALLOC);
+    
     /* Calculate total code size required for all registered PICOs */
     SIZE_T totalCodeSize = TotalCodeSize(manager);
     
@@ -176,97 +682,1634 @@ BOOL PicoManagerAlloc(PPICO_MANAGER manager, SIZE_T finalPadding) {
     /* Add final padding */
     SIZE_T requiredBlockSize = totalCodeSize + paddingSize + finalPadding;
     
+    /* Data slots for every PICO not loaded yet go in the same reservation */
+    SIZE_T dataSize = 0;
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
+        if (entry->vault && !entry->data) {
+            dataSize += DATA_SLOT_SIZE(entry->dataSize);
+        }
+    }
+    
     /* Allocate new RWX block */
-    manager->baseAddress = (char*)KERNEL32$VirtualAlloc(NULL, requiredBlockSize, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+    char* dataSlot;
+    manager->baseAddress = ReserveCodeBlock(manager, &requiredBlockSize, dataSize, &dataSlot);
     if (!manager->baseAddress) {
-        return FALSE;
+        return PicoStatsLeave(&manager->stats, operation, FALSE);
     }
     
     manager->blockSize = requiredBlockSize;
     manager->usedSize = 0;
     
+    for (DWORD i = 0; i < manager->entryCount && dataSlot; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
+        if (entry->vault && !entry->data) {
+            entry->dataSlot = dataSlot;
+            dataSlot += DATA_SLOT_SIZE(entry->dataSize);
+        }
+    }
+    
+    return PicoStatsLeave(&manager->stats, operation, TRUE);
+}
+
+/*
+ * Computes the whole pages owned by a PICO code range at a given address.
+ * Pages shared with a neighbour or padding are excluded.
+ */
+static SIZE_T CodePages(PPICO_ENTRY entry, char* code, ULONG_PTR* start) {
+    ULONG_PTR first = ((ULONG_PTR)code + PICO_PAGE_SIZE - 1) & ~(ULONG_PTR)(PICO_PAGE_SIZE - 1);
+    ULONG_PTR last = ((ULONG_PTR)code + entry->codeSize) & ~(ULONG_PTR)(PICO_PAGE_SIZE - 1);
+    
+    *start = first;
+    return (last > first) ? (SIZE_T)(last - first) : 0;
+}
+
+/*
+ * Gives back a PICO's data section. Data slots stay the PICO's and are
+ * decommitted, or cleared for the next load if that fails.
+ */
+static void ReleaseData(PPICO_MANAGER manager, PPICO_ENTRY entry) {
+    if (entry->dataSlot) {
+        if (!PicoMemoryDecommit(manager->allocator, &manager->stats, entry->dataSlot, DATA_SLOT_SIZE(entry->dataSize), PICO_MEMORY_DATA)) {
+            MSVCRT$memset(entry->dataSlot, 0, entry->dataSize);
+        }
+    } else {
+        PicoMemoryRelease(manager->allocator, &manager->stats, entry->data, entry->dataSize, PICO_MEMORY_DATA);
+    }
+    
+    entry->data = NULL;
+}
+
+/*
+ * Releases the code pages and data section of a loaded PICO the caller
+ * has claimed, keeping its registration and vault so it can be loaded again.
+ * Code pages stay committed unless decommit is set.
+ */
+static BOOL UnloadClaimed(PPICO_MANAGER manager, PPICO_ENTRY entry, BOOL decommit) {
+    if (!entry->code) return FALSE;
+    
+    ExportRegistryRemove(manager, entry);
+    
+    if (manager->verifyEntry == entry->id) {
+        manager->verifyOffset = 0;
+    }
+    
+    /* Decommit the pages only this PICO occupies; LoadPico recommits them. Large pages stay. */
+    ULONG_PTR start;
+    SIZE_T size = (!decommit || manager->largePageSize) ? 0 : CodePages(entry, entry->code, &start);
+    if (size > 0 && PicoMemoryDecommit(manager->allocator, &manager->stats, (char*)start, size, PICO_MEMORY_CODE)) {
+        entry->flags |= PICO_FLAG_DECOMMITTED;
+    }
+    
+    if (entry->data) {
+        ReleaseData(manager, entry);
+        manager->residentData -= entry->dataSize;
+    }
+    
+    manager->residentCode -= entry->codeSize;
+    
+    /* The next load starts from fresh data, so its init entry point runs again */
+    entry->flags &= ~PICO_FLAG_INITIALIZED;
+    entry->code = NULL;
+    entry->data = NULL;
+    entry->entryPoint = NULL;
     return TRUE;
 }
 
 /*
- * Loads all registered but not yet loaded PICOs into the manager's RWX block.
- * Places PICO code sections sequentially in the shared RWX block with padding.
+ * Unloads a PICO no executor task is using.
  */
-BOOL LoadPico(PPICO_MANAGER manager, DWORD upToEntryId, SIZE_T finalPadding, IMPORTFUNCS * funcs) {
-    if (!manager) return FALSE;
-    if (!manager->baseAddress || manager->blockSize == 0) return FALSE;
+static BOOL UnloadEntry(PPICO_MANAGER manager, PPICO_ENTRY entry, BOOL decommit) {
+    if (!entry->code || !PicoEntryClaim(entry)) return FALSE;
     
-    SIZE_T codeOffset = 0;
-    DWORD loadUpTo = (upToEntryId == (DWORD)-1) ? manager->entryCount : (upToEntryId + 1);
+    BOOL unloaded = UnloadClaimed(manager, entry, decommit);
     
-    /* Process all entries up to specified ID: skip already loaded, load new ones */
-    for (DWORD i = 0; i < loadUpTo && i < manager->entryCount; i++) {
+    PicoEntryUnclaim(entry);
+    return unloaded;
+}
+
+/*
+ * Evicts least recently used PICOs until the given one fits in the budget.
+ * Pinned, init, in-flight and half-loaded PICOs are never evicted.
+ * A large-page block stays committed whole, evicting gives no code memory
+ * back there, so only the data budget applies.
+ */
+static BOOL EnsureBudget(PPICO_MANAGER manager, PPICO_ENTRY entry) {
+    SIZE_T codeBudget = manager->largePageSize ? 0 : manager->codeBudget;
+    
+    while ((codeBudget && manager->residentCode + entry->codeSize > codeBudget) ||
+           (manager->dataBudget && manager->residentData + entry->dataSize > manager->dataBudget)) {
+        PPICO_ENTRY victim = NULL;
+        
+        for (DWORD i = 0; i < manager->entryCount; i++) {
+            PPICO_ENTRY candidate = &manager->entries[i];
+            
+            if (!candidate->code || candidate == entry || candidate->activeTasks) continue;
+            if (candidate->flags & (PICO_FLAG_PINNED | PICO_FLAG_INIT | PICO_FLAG_LOADING)) continue;
+            
+            if (!victim || candidate->lastUse < victim->lastUse) {
+                victim = candidate;
+            }
+        }
+        
+        /* Nothing left to evict: the PICO cannot fit */
+        if (!victim || !UnloadEntry(manager, victim, TRUE)) {
+            return FALSE;
+        }
+    }
+    
+    return TRUE;
+}
+
+/*
+ * Checks that a data range is within 32-bit displacement reach of a code
+ * range: PICO_INST_PATCH_DIFF adds dstData - dstCode into 32-bit fields on
+ * x64. Addresses are 32-bit on x86, so anything is in reach there.
+ */
+static BOOL DataInReach(char* code, SIZE_T codeSize, char* data, SIZE_T dataSize) {
+#ifdef WIN_X64
+    if (!data) return FALSE;
+    
+    LONG_PTR lowest = (LONG_PTR)((ULONG_PTR)data - ((ULONG_PTR)code + codeSize));
+    LONG_PTR highest = (LONG_PTR)(((ULONG_PTR)data + dataSize) - (ULONG_PTR)code);
+    
+    return lowest >= -(LONG_PTR)0x80000000 && highest <= (LONG_PTR)0x7FFFFFFF;
+#else
+    return data != NULL;
+#endif
+}
+
+/*
+ * Checks that a PICO placed at codeOffset fits in the code block, leaving
+ * the inter-PICO padding after it and the final padding after that.
+ */
+static BOOL BlockFits(PPICO_MANAGER manager, SIZE_T codeOffset, SIZE_T codeSize, SIZE_T finalPadding) {
+    return codeOffset + codeSize + manager->interPicoPadding + finalPadding <= manager->blockSize;
+}
+
+/*
+ * Carves a data slot out of the data arena (PICO_BLOCK_DATA_ARENA). The
+ * arena is a reservation of its own, separate from the metadata arena,
+ * made on first use with whole pages for every registered PICO that has
+ * no slot yet. Returns NULL if it is full or out of the code's reach.
+ */
+static char* DataArenaAlloc(PPICO_MANAGER manager, PPICO_ENTRY entry, char* code) {
+    if (!manager->dataArenaBase) {
+        SIZE_T size = 0;
+        
+        for (DWORD i = 0; i < manager->entryCount; i++) {
+            if (manager->entries[i].vault && !manager->entries[i].dataSlot) {
+                size += DATA_SLOT_SIZE(manager->entries[i].dataSize);
+            }
+        }
+        if (size == 0) return NULL;
+        
+        manager->dataArenaBase = PicoMemoryReserve(manager->allocator, &manager->stats, size, 0, PICO_MEMORY_DATA);
+        if (!manager->dataArenaBase) return NULL;
+        
+        manager->dataArenaSize = size;
+        manager->dataArenaUsed = 0;
+    }
+    
+    SIZE_T slotSize = DATA_SLOT_SIZE(entry->dataSize);
+    if (slotSize > manager->dataArenaSize - manager->dataArenaUsed) return NULL;
+    if (!DataInReach(code, entry->codeSize, manager->dataArenaBase, manager->dataArenaSize)) return NULL;
+    
+    char* slot = manager->dataArenaBase + manager->dataArenaUsed;
+    manager->dataArenaUsed += slotSize;
+    return slot;
+}
+
+/*
+ * Assigns a PICO its position in the shared RWX block and allocates its data section.
+ */
+static BOOL PlacePico(PPICO_MANAGER manager, PPICO_ENTRY entry, SIZE_T codeOffset) {
+    char* code = manager->baseAddress + codeOffset;
+    
+    /* Make room under the memory budget first */
+    if (!EnsureBudget(manager, entry)) {
+        return FALSE;
+    }
+    
+    /* Data sections can live in the data arena: the slot stays the entry's for later loads */
+    if (!entry->dataSlot && (manager->blockOptions & PICO_BLOCK_DATA_ARENA)) {
+        entry->dataSlot = DataArenaAlloc(manager, entry, code);
+    }
+    
+    /* Allocate separate RW block for data section, unless a slot is reserved for it */
+    if (entry->dataSlot) {
+        if (!PicoMemoryCommit(manager->allocator, &manager->stats, entry->dataSlot, DATA_SLOT_SIZE(entry->dataSize), PAGE_READWRITE, PICO_MEMORY_DATA)) {
+            return FALSE;
+        }
+        entry->data = entry->dataSlot;
+    } else {
+        entry->data = PicoMemoryReserve(manager->allocator, &manager->stats, entry->dataSize, PAGE_READWRITE, PICO_MEMORY_DATA);
+        if (!entry->data) {
+            return FALSE;
+        }
+    }
+    
+    /* Never load an image whose data displacements would be truncated */
+    if (!DataInReach(code, entry->codeSize, entry->data, entry->dataSize)) {
+        ReleaseData(manager, entry);
+        return FALSE;
+    }
+    
+    /* Bring back code pages decommitted when this PICO was evicted */
+    if (entry->flags & PICO_FLAG_DECOMMITTED) {
+        ULONG_PTR start;
+        SIZE_T size = CodePages(entry, manager->baseAddress + codeOffset, &start);
+        if (size > 0 && !PicoMemoryCommit(manager->allocator, &manager->stats, (char*)start, size, PAGE_EXECUTE_READWRITE, PICO_MEMORY_CODE)) {
+            ReleaseData(manager, entry);
+            return FALSE;
+        }
+        entry->flags &= ~PICO_FLAG_DECOMMITTED;
+    }
+    
+    /* Assign position in shared RWX block */
+    entry->code = code;
+    entry->flags |= PICO_FLAG_LOADING;
+    entry->lastUse = ++manager->useClock;
+    
+    manager->residentCode += entry->codeSize;
+    manager->residentData += entry->dataSize;
+    return TRUE;
+}
+
+/*
+ * Takes back the placement of a PICO that was not loaded after all: it is
+ * registered but unloaded again, as it was before PlacePico.
+ */
+static void UnplacePico(PPICO_MANAGER manager, PPICO_ENTRY entry) {
+    ReleaseData(manager, entry);
+    
+    manager->residentCode -= entry->codeSize;
+    manager->residentData -= entry->dataSize;
+    
+    entry->code = NULL;
+    entry->flags &= ~PICO_FLAG_LOADING;
+}
+
+/*
+ * Finishes a PICO whose image has been loaded: entry point and exports.
+ */
+static void CompletePico(PPICO_MANAGER manager, PPICO_ENTRY entry) {
+    /* Calculate entry point */
+    entry->entryPoint = (char*)PicoEntryPoint(entry->vault, entry->code);
+    entry->flags &= ~PICO_FLAG_LOADING;
+    
+    /* Reference checksum for integrity scans */
+    entry->codeCrc = PicoManagerCrc32c(manager, 0, entry->code, entry->codeSize);
+    
+    /* Cache resolved imports for data resets while the function table is still pristine */
+    if (!entry->imports && manager->arenaBase) {
+        int importCount = entry->info ? (int)entry->info->importCount : PicoImportCount(entry->vault);
+        if (importCount > 0) {
+            entry->imports = (ULONG_PTR*)PicoManagerArenaAlloc(manager, sizeof(ULONG_PTR) * importCount, sizeof(ULONG_PTR));
+        }
+    }
+    if (entry->imports) {
+        PicoCaptureImports(entry->vault, entry->data, entry->imports);
+    }
+    
+    /* The checksum above already read the code in; data pages may still be untouched */
+    if (manager->blockOptions & PICO_BLOCK_PREFAULT) {
+        TouchPages(entry->data, entry->dataSize);
+    }
+    
+    /* Publish its exports */
+    ExportRegistryInsert(manager, entry);
+}
+
+/*
+ * Counts the import calls a loader pass resolving a PICO's imports makes
+ * through IMPORTFUNCS: one per LL and per GPA directive.
+ */
+static void CountImportCalls(PPICO_MANAGER manager, PPICO_ENTRY entry) {
+    int libraries;
+    int procedures;
+    
+    if (entry->info) {
+        libraries = entry->info->libraryCount;
+        procedures = entry->info->procedureCount;
+    } else {
+        PicoResolveCount(entry->vault, &libraries, &procedures);
+    }
+    
+    PicoStatsAdd(&manager->stats, PICO_CALL_LOADLIBRARY, libraries);
+    PicoStatsAdd(&manager->stats, PICO_CALL_GETPROCADDRESS, procedures);
+}
+
+/* ========================================================================
+ * PARALLEL LOADING FUNCTIONS
+ * ======================================================================== */
+
+typedef struct {
+    IMPORTFUNCS* funcs;
+    PPICO_ENTRY entry;
+    int phase;
+    PPICO_LOAD_RANGE range;
+    PICO_TASK task;
+} PICO_LOAD_PART;
+
+/*
+ * Executor task routine loading one part of a placed PICO.
+ */
+static void LoadPartTask(char* arg) {
+    PICO_LOAD_PART* part = (PICO_LOAD_PART*)arg;
+    
+    PicoLoadPart(part->funcs, part->entry->vault, part->entry->code, part->entry->data, part->phase, part->range);
+}
+
+/*
+ * Runs the parts of one loader phase and returns once all of them are done.
+ * The calling thread takes part 0, the executor workers the rest.
+ */
+static void LoadPhase(PPICO_MANAGER manager, PICO_LOAD_PART* parts, DWORD count) {
+    /* Parts are waited for below, so they hold no entry; an update runs them on a claimed one */
+    for (DWORD i = 1; i < count; i++) {
+        parts[i].task.entry = NULL;
+        parts[i].task.function = (char*)LoadPartTask;
+        parts[i].task.arg = (char*)&parts[i];
+        if (!SubmitPicoTask(manager, &parts[i].task)) {
+            LoadPartTask((char*)&parts[i]);
+            parts[i].task.state = PICO_TASK_DONE;
+        }
+    }
+    
+    LoadPartTask((char*)&parts[0]);
+    
+    /* The next phase reads what this one wrote; a part a stopping executor dropped runs here */
+    for (DWORD i = 1; i < count; i++) {
+        if (!WaitPicoTask(manager, &parts[i].task)) {
+            LoadPartTask((char*)&parts[i]);
+        }
+    }
+}
+
+/*
+ * Runs the loader over a placed PICO. With the executor started, big PICOs
+ * are loaded in parts on its workers, with every part of the copy phase done
+ * before patching starts. The directive stream is cut into parts once, and
+ * PICOs whose copies and patches are interleaved are loaded whole.
+ */
+static void LoadImage(PPICO_MANAGER manager, IMPORTFUNCS * funcs, PPICO_ENTRY entry) {
+    DWORD64 start = PicoStatsStart(&manager->stats);
+    int copyBytes;
+    int patches;
+    
+    if (manager->loadParts > 1 && manager->executor && PicoSplitCount(entry->vault, &copyBytes, &patches) &&
+        (SIZE_T)copyBytes >= manager->loadThreshold) {
+        PICO_LOAD_RANGE ranges[2 * PICO_LOAD_PARTS_MAX];
+        PICO_LOAD_PART parts[PICO_LOAD_PARTS_MAX];
+        
+        PicoLoadSplit(entry->vault, copyBytes, patches, manager->loadParts, ranges);
+        
+        for (int phase = PICO_LOAD_COPY; phase <= PICO_LOAD_PATCH; phase++) {
+            for (DWORD i = 0; i < manager->loadParts; i++) {
+                parts[i].funcs = funcs;
+                parts[i].entry = entry;
+                parts[i].phase = phase;
+                parts[i].range = &ranges[phase * manager->loadParts + i];
+            }
+            LoadPhase(manager, parts, manager->loadParts);
+        }
+        
+        /* Imports resolve in directive order, IMPORTFUNCS may not be thread-safe */
+        PicoLoadPart(funcs, entry->vault, entry->code, entry->data, PICO_LOAD_IMPORTS, NULL);
+    } else {
+        PicoLoad(funcs, entry->vault, entry->code, entry->data);
+    }
+    
+    PicoStatsStop(&manager->stats, PICO_CALL_LOADER, start);
+    CountImportCalls(manager, entry);
+}
+
+/*
+ * Sets how the loads of big PICOs are split across threads.
+ */
+BOOL PicoManagerSetParallelLoad(PPICO_MANAGER manager, DWORD parts, SIZE_T threshold) {
+    if (!manager || parts > PICO_LOAD_PARTS_MAX) return FALSE;
+    
+    manager->loadParts = parts;
+    manager->loadThreshold = threshold;
+    return TRUE;
+}
+
+/*
+ * Loads all registered but not yet loaded PICOs into the manager's RWX block.
+ * Places PICO code sections sequentially in the shared RWX block with padding.
+ */
+BOOL LoadPico(PPICO_MANAGER manager, DWORD upToEntryId, SIZE_T finalPadding, IMPORTFUNCS * funcs) {
+    if (!manager) return FALSE;
+    if (!manager->baseAddress || manager->blockSize == 0) return FALSE;
+    
+    SIZE_T codeOffset = 0;
+    DWORD loadUpTo = (upToEntryId == (DWORD)-1) ? manager->entryCount : (upToEntryId + 1);
+    
+    /* Remembered for reloading evicted PICOs and kept free by updates */
+    manager->funcs = funcs;
+    manager->finalPadding = finalPadding;
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_LOAD);
+    
+    /* Process all entries up to specified ID: skip already loaded, load new ones */
+    for (DWORD i = 0; i < loadUpTo && i < manager->entryCount; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
+        
+        /* If already loaded, just advance offset */
+        if (entry->code) {
+            codeOffset += entry->codeSize + manager->interPicoPadding;
+            continue;
+        }
+        
+        /* If no vault, skip empty entry */
+        if (!entry->vault) continue;
+        
+        /* Check if there's enough space */
+        if (!BlockFits(manager, codeOffset, entry->codeSize, finalPadding)) {
+            return PicoStatsLeave(&manager->stats, operation, FALSE);
+        }
+        
+        if (!PlacePico(manager, entry, codeOffset)) {
+            return PicoStatsLeave(&manager->stats, operation, FALSE);
+        }
+        
+        /* Load the PICO */
+        LoadImage(manager, funcs, entry);
+        
+        CompletePico(manager, entry);
+        
+        /* Advance offset for next PICO */
+        codeOffset += entry->codeSize + manager->interPicoPadding;
+    }
+    
+    manager->usedSize = codeOffset;
+    return PicoStatsLeave(&manager->stats, operation, TRUE);
+}
+
+/* ========================================================================
+ * SCHEDULED LOADING FUNCTIONS
+ * ======================================================================== */
+
+typedef struct {
+    IMPORTFUNCS* funcs;
+    PPICO_ENTRY entry;
+    PICO_TASK task;
+} PICO_LOAD_TASK;
+
+/*
+ * Executor task routine loading a single placed PICO.
+ */
+static void LoadPicoTask(char* arg) {
+    PICO_LOAD_TASK* task = (PICO_LOAD_TASK*)arg;
+    
+    PicoLoad(task->funcs, task->entry->vault, task->entry->code, task->entry->data);
+}
+
+/*
+ * Thread routine loading a single placed PICO.
+ */
+static DWORD WINAPI LoadPicoThread(LPVOID param) {
+    LoadPicoTask((char*)param);
+    return 0;
+}
+
+/*
+ * Loads a level of placed PICOs concurrently. With the executor started its
+ * workers take every PICO but the first, which the calling thread loads;
+ * otherwise each PICO gets a thread of its own. A single PICO, or one whose
+ * task or thread cannot be started, is loaded on the calling thread.
+ */
+static void LoadPicoLevel(PPICO_MANAGER manager, PICO_LOAD_TASK* tasks, DWORD count) {
+    HANDLE threads[MAXIMUM_WAIT_OBJECTS];
+    DWORD started = 0;
+    
+    if (count == 1) {
+        LoadPicoTask((char*)&tasks[0]);
+        return;
+    }
+    
+    if (manager->executor) {
+        /* Tasks are waited for below, so they hold no entry, like LoadPhase */
+        for (DWORD i = 1; i < count; i++) {
+            tasks[i].task.entry = NULL;
+            tasks[i].task.function = (char*)LoadPicoTask;
+            tasks[i].task.arg = (char*)&tasks[i];
+            if (!SubmitPicoTask(manager, &tasks[i].task)) {
+                LoadPicoTask((char*)&tasks[i]);
+                tasks[i].task.state = PICO_TASK_DONE;
+            }
+        }
+        
+        LoadPicoTask((char*)&tasks[0]);
+        
+        /* A PICO a stopping executor dropped is loaded here */
+        for (DWORD i = 1; i < count; i++) {
+            if (!WaitPicoTask(manager, &tasks[i].task)) {
+                LoadPicoTask((char*)&tasks[i]);
+            }
+        }
+        return;
+    }
+    
+    for (DWORD i = 0; i < count; i++) {
+        DWORD64 start = PicoStatsStart(&manager->stats);
+        threads[started] = KERNEL32$CreateThread(NULL, 0, LoadPicoThread, &tasks[i], 0, NULL);
+        PicoStatsStop(&manager->stats, PICO_CALL_THREAD, start);
+        if (threads[started]) {
+            started++;
+        } else {
+            LoadPicoTask((char*)&tasks[i]);
+        }
+    }
+    
+    if (started > 0) {
+        KERNEL32$WaitForMultipleObjects(started, threads, TRUE, INFINITE);
+    }
+    
+    for (DWORD i = 0; i < started; i++) {
+        KERNEL32$CloseHandle(threads[i]);
+    }
+}
+
+/*
+ * Declares that a PICO needs another PICO loaded (and optionally executed) first.
+ */
+BOOL AddPicoDependency(PPICO_MANAGER manager, const char* name, const char* dependency, DWORD requirement) {
+    if (!manager || !name || !dependency) return FALSE;
+    
+    PPICO_ENTRY entry = GetPicoByName(manager, name);
+    PPICO_ENTRY needed = GetPicoByName(manager, dependency);
+    if (!entry || !needed || entry == needed) return FALSE;
+    if (needed->id >= PICO_SCHEDULE_MAX) return FALSE;
+    
+    entry->dependencies |= ((DWORD64)1) << needed->id;
+    
+    if (requirement == PICO_DEPENDENCY_EXECUTED) {
+        needed->flags |= PICO_FLAG_INIT;
+    }
+    
+    return TRUE;
+}
+
+/*
+ * Pins or unpins the PICOs in a mask, see LoadPicoScheduled.
+ */
+static void PinEntries(PPICO_MANAGER manager, DWORD64 mask, BOOL pin) {
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        if (!(mask & (((DWORD64)1) << i))) continue;
+        
+        if (pin) {
+            manager->entries[i].flags |= PICO_FLAG_PINNED;
+        } else {
+            manager->entries[i].flags &= ~PICO_FLAG_PINNED;
+        }
+    }
+}
+
+/*
+ * Loads all registered but not yet loaded PICOs in dependency order.
+ * Each level of the dependency graph is loaded in parallel; init entry points
+ * of a level run before the next level starts.
+ */
+BOOL LoadPicoScheduled(PPICO_MANAGER manager, SIZE_T finalPadding, IMPORTFUNCS * funcs, char* initArg) {
+    if (!manager || !funcs) return FALSE;
+    if (!manager->baseAddress || manager->blockSize == 0) return FALSE;
+    if (manager->entryCount > PICO_SCHEDULE_MAX) return FALSE;
+    
+    SIZE_T offsets[PICO_SCHEDULE_MAX];
+    SIZE_T codeOffset = 0;
+    DWORD64 done = 0;
+    DWORD64 pending = 0;
+    
+    /* Remembered for reloading evicted PICOs and kept free by updates */
+    manager->funcs = funcs;
+    manager->finalPadding = finalPadding;
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_LOAD);
+    
+    /* Same sequential layout as LoadPico, so both can be mixed freely */
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
+        DWORD64 bit = ((DWORD64)1) << i;
+        
+        offsets[i] = codeOffset;
+        
+        if (!entry->vault) {
+            done |= bit;
+            continue;
+        }
+        
+        /* A loaded PICO still owes its init entry point if another load placed it */
+        if (entry->code && (entry->flags & (PICO_FLAG_INIT | PICO_FLAG_INITIALIZED)) != PICO_FLAG_INIT) {
+            done |= bit;
+        } else {
+            pending |= bit;
+        }
+        
+        codeOffset += entry->codeSize + manager->interPicoPadding;
+    }
+    
+    if (codeOffset + finalPadding > manager->blockSize) {
+        return PicoStatsLeave(&manager->stats, operation, FALSE);
+    }
+    
+    /* Making room for a dependent must not evict what it depends on */
+    DWORD64 held = 0;
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        if (pending & (((DWORD64)1) << i)) {
+            held |= manager->entries[i].dependencies;
+        }
+    }
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        if (manager->entries[i].flags & PICO_FLAG_PINNED) {
+            held &= ~(((DWORD64)1) << i);
+        }
+    }
+    PinEntries(manager, held, TRUE);
+    
+    BOOL loaded = TRUE;
+    
+    while (pending && loaded) {
+        PICO_LOAD_TASK tasks[PICO_SCHEDULE_MAX];
+        DWORD count = 0;
+        DWORD64 level = 0;
+        
+        /* Next level: everything whose dependencies are satisfied */
+        for (DWORD i = 0; i < manager->entryCount; i++) {
+            DWORD64 bit = ((DWORD64)1) << i;
+            if ((pending & bit) && (manager->entries[i].dependencies & ~done) == 0) {
+                level |= bit;
+            }
+        }
+        
+        /* Nothing ready means a dependency cycle */
+        if (!level) {
+            loaded = FALSE;
+            break;
+        }
+        
+        /* Placement stays on this thread so only PicoLoad runs concurrently */
+        for (DWORD i = 0; i < manager->entryCount && loaded; i++) {
+            if (!(level & (((DWORD64)1) << i)) || manager->entries[i].code) continue;
+            
+            if (!PlacePico(manager, &manager->entries[i], offsets[i])) {
+                loaded = FALSE;
+                break;
+            }
+            
+            tasks[count].funcs = funcs;
+            tasks[count].entry = &manager->entries[i];
+            count++;
+        }
+        
+        /* A level that cannot be placed whole is not loaded at all, so no PICO is left half-loaded */
+        if (!loaded) {
+            for (DWORD i = 0; i < count; i++) {
+                UnplacePico(manager, tasks[i].entry);
+            }
+            break;
+        }
+        
+        /* Counted here, the loader threads do not touch the statistics */
+        for (DWORD i = 0; i < count; i++) {
+            CountImportCalls(manager, tasks[i].entry);
+        }
+        PicoStatsAdd(&manager->stats, PICO_CALL_LOADER, count);
+        LoadPicoLevel(manager, tasks, count);
+        
+        for (DWORD i = 0; i < count; i++) {
+            CompletePico(manager, tasks[i].entry);
+        }
+        
+        /* Run required init entry points before dependents are loaded, once per load */
+        for (DWORD i = 0; i < manager->entryCount; i++) {
+            PPICO_ENTRY entry = &manager->entries[i];
+            
+            if (!(level & (((DWORD64)1) << i))) continue;
+            if ((entry->flags & (PICO_FLAG_INIT | PICO_FLAG_INITIALIZED)) != PICO_FLAG_INIT) continue;
+            
+            ((PICOMAIN_FUNC)entry->entryPoint)(initArg);
+            entry->flags |= PICO_FLAG_INITIALIZED;
+        }
+        
+        done |= level;
+        pending &= ~level;
+    }
+    
+    PinEntries(manager, held, FALSE);
+    if (!loaded) return PicoStatsLeave(&manager->stats, operation, FALSE);
+    
+    manager->usedSize = codeOffset;
+    return PicoStatsLeave(&manager->stats, operation, TRUE);
+}
+
+/* ========================================================================
+ * MEMORY BUDGET FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Configures the memory budget for resident PICO code and data.
+ */
+BOOL PicoManagerSetBudget(PPICO_MANAGER manager, SIZE_T codeBudget, SIZE_T dataBudget, IMPORTFUNCS * funcs) {
+    if (!manager) return FALSE;
+    
+    manager->codeBudget = codeBudget;
+    manager->dataBudget = dataBudget;
+    if (funcs) {
+        manager->funcs = funcs;
+    }
+    
+    return TRUE;
+}
+
+/*
+ * Computes the block offset of an entry in the sequential layout LoadPico uses.
+ */
+static SIZE_T EntryOffset(PPICO_MANAGER manager, DWORD id) {
+    SIZE_T codeOffset = 0;
+    
+    for (DWORD i = 0; i < id; i++) {
+        if (manager->entries[i].vault) {
+            codeOffset += manager->entries[i].codeSize + manager->interPicoPadding;
+        }
+    }
+    
+    return codeOffset;
+}
+
+/*
+ * Marks a PICO as used and loads it again if it was evicted.
+ * Uses the same block position LoadPico gives it.
+ */
+PPICO_ENTRY UsePicoById(PPICO_MANAGER manager, DWORD id) {
+    if (!manager || id >= manager->entryCount) return NULL;
+    
+    PPICO_ENTRY entry = &manager->entries[id];
+    if (!entry->vault) return NULL;
+    
+    if (!entry->code) {
+        if (!manager->baseAddress || !manager->funcs) return NULL;
+        
+        DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_LOAD);
+        
+        SIZE_T codeOffset = EntryOffset(manager, id);
+        if (!BlockFits(manager, codeOffset, entry->codeSize, manager->finalPadding) || !PlacePico(manager, entry, codeOffset)) {
+            PicoStatsLeave(&manager->stats, operation, FALSE);
+            return NULL;
+        }
+        
+        LoadImage(manager, manager->funcs, entry);
+        
+        CompletePico(manager, entry);
+        PicoStatsLeave(&manager->stats, operation, TRUE);
+    }
+    
+    entry->lastUse = ++manager->useClock;
+    return entry;
+}
+
+/*
+ * Marks a PICO as used by name and loads it again if it was evicted.
+ */
+PPICO_ENTRY UsePicoByName(PPICO_MANAGER manager, const char* name) {
+    if (!manager || !name) return NULL;
+    
+    PPICO_ENTRY entry = GetPicoByName(manager, name);
+    if (!entry) return NULL;
+    
+    return UsePicoById(manager, entry->id);
+}
+
+/* ========================================================================
+ * UPDATE FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Points an entry at a vault and its vault cache slot. The caller keeps the
+ * reference the entry held on the old slot until the update is settled.
+ */
+static void SwapVault(PPICO_ENTRY entry, char* vault, PPICO_VAULT_INFO info) {
+    entry->info = info;
+    entry->vault = vault;
+    entry->codeSize = info ? info->codeSize : PicoCodeSize(vault);
+    entry->dataSize = info ? info->dataSize : PicoDataSize(vault);
+}
+
+/*
+ * Replaces the vault of a claimed PICO. When the new vault builds the very
+ * same data section at the same code size, loaded code is rebuilt in place
+ * and the live data section, function table and import cache are kept.
+ * Otherwise a loaded PICO is unloaded and loaded again at its position.
+ */
+static BOOL UpdateClaimed(PPICO_MANAGER manager, PPICO_ENTRY entry, char* vault) {
+    DWORD id = entry->id;
+    
+    SIZE_T codeSize = PicoCodeSize(vault);
+    SIZE_T codeOffset = entry->code ? (SIZE_T)(entry->code - manager->baseAddress) : EntryOffset(manager, id);
+    
+    /* Later PICOs sit right after this one, a loaded one pins the code size */
+    if (codeSize != entry->codeSize) {
+        for (DWORD i = id + 1; i < manager->entryCount; i++) {
+            if (manager->entries[i].code) return FALSE;
+        }
+    }
+    
+    /* A bootstrap data slot cannot grow past its pages; other slots are given up for a data section of its own */
+    BOOL regrow = entry->dataSlot && (SIZE_T)PicoDataSize(vault) > DATA_SLOT_SIZE(entry->dataSize);
+    if (regrow && manager->bootstrapBase) return FALSE;
+    
+    /* The old vault may be a stored copy that goes away with its last reference, kept until the update holds */
+    char* oldVault = entry->vault;
+    PPICO_VAULT_INFO oldInfo = entry->info;
+    
+    if (entry->code && codeSize == entry->codeSize && PicoSameData(entry->vault, vault)) {
+        ExportRegistryRemove(manager, entry);
+        SwapVault(entry, vault, PicoVaultCacheLookup(manager->vaultCache, vault));
+        PicoVaultRelease(oldInfo);
+        
+        DWORD64 start = PicoStatsStart(&manager->stats);
+        PicoLoadCode(vault, entry->code, entry->data);
+        PicoStatsStop(&manager->stats, PICO_CALL_LOADER, start);
+        
+        entry->entryPoint = (char*)PicoEntryPoint(vault, entry->code);
+        entry->codeCrc = PicoManagerCrc32c(manager, 0, entry->code, entry->codeSize);
+        if (manager->verifyEntry == id) {
+            manager->verifyOffset = 0;
+        }
+        
+        ExportRegistryInsert(manager, entry);
+        return TRUE;
+    }
+    
+    BOOL loaded = (entry->code != NULL);
+    if (loaded && (!manager->funcs || !BlockFits(manager, codeOffset, codeSize, manager->finalPadding))) return FALSE;
+    
+    ULONG_PTR* oldImports = entry->imports;
+    char* oldSlot = entry->dataSlot;
+    
+    if (!loaded && (entry->flags & PICO_FLAG_DECOMMITTED)) {
+        /* Pages decommitted for the old size would not all come back for the new one */
+        ULONG_PTR start;
+        SIZE_T size = CodePages(entry, manager->baseAddress + codeOffset, &start);
+        if (size > 0 && !PicoMemoryCommit(manager->allocator, &manager->stats, (char*)start, size, PAGE_EXECUTE_READWRITE, PICO_MEMORY_CODE)) {
+            return FALSE;
+        }
+        entry->flags &= ~PICO_FLAG_DECOMMITTED;
+    }
+    
+    if (loaded && !UnloadClaimed(manager, entry, FALSE)) return FALSE;
+    
+    /* The import cache was sized for the old vault */
+    if (PicoImportCount(vault) > (oldInfo ? (int)oldInfo->importCount : PicoImportCount(oldVault))) {
+        entry->imports = NULL;
+    }
+    
+    /* The slot's pages were decommitted by the unload and stay reserved, unused */
+    if (regrow) {
+        entry->dataSlot = NULL;
+    }
+    
+    PPICO_VAULT_INFO info = PicoVaultCacheLookup(manager->vaultCache, vault);
+    SwapVault(entry, vault, info);
+    
+    if (loaded && !PlacePico(manager, entry, codeOffset)) {
+        /* Back to the old vault, loaded again from it with a fresh data section if it still places */
+        SwapVault(entry, oldVault, oldInfo);
+        PicoVaultRelease(info);
+        
+        entry->imports = oldImports;
+        entry->dataSlot = oldSlot;
+        
+        if (PlacePico(manager, entry, codeOffset)) {
+            LoadImage(manager, manager->funcs, entry);
+            CompletePico(manager, entry);
+        }
+        return FALSE;
+    }
+    
+    PicoVaultRelease(oldInfo);
+    if (!loaded) return TRUE;
+    
+    LoadImage(manager, manager->funcs, entry);
+    
+    CompletePico(manager, entry);
+    
+    if (codeOffset + codeSize > manager->usedSize) {
+        manager->usedSize = codeOffset + codeSize;
+    }
+    return TRUE;
+}
+
+/*
+ * Replaces the vault of a PICO no executor task is using.
+ */
+BOOL UpdatePicoById(PPICO_MANAGER manager, DWORD id, char* vault) {
+    if (!manager || !vault || id >= manager->entryCount) return FALSE;
+    
+    PPICO_ENTRY entry = &manager->entries[id];
+    if (!entry->vault || (entry->flags & PICO_FLAG_LOADING)) return FALSE;
+    
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_UPDATE);
+    
+    /* No task may start on the old code while it is rebuilt or moved */
+    if (!PicoEntryClaim(entry)) return PicoStatsLeave(&manager->stats, operation, FALSE);
+    
+    BOOL updated = UpdateClaimed(manager, entry, vault);
+    
+    PicoEntryUnclaim(entry);
+    return PicoStatsLeave(&manager->stats, operation, updated);
+}
+
+/*
+ * Replaces the vault of a PICO by name.
+ */
+BOOL UpdatePicoByName(PPICO_MANAGER manager, const char* name, char* vault) {
+    if (!manager || !name) return FALSE;
+    
+    PPICO_ENTRY entry = GetPicoByName(manager, name);
+    if (!entry) return FALSE;
+    
+    return UpdatePicoById(manager, entry->id, vault);
+}
+
+/* ========================================================================
+ * CODE BLOCK OPTION FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Sets large page backing and prefaulting for the code block, and where data sections live.
+ */
+BOOL PicoManagerSetBlockOptions(PPICO_MANAGER manager, DWORD options) {
+    if (!manager || manager->baseAddress) return FALSE;
+    
+    manager->blockOptions = options;
+    return TRUE;
+}
+
+/*
+ * Reads one byte of every page in a range. Committed pages become resident
+ * on first access, read or write.
+ */
+static void TouchPages(char* start, SIZE_T size) {
+    volatile char* cursor = start;
+    
+    if (!start || size == 0) return;
+    
+    for (SIZE_T offset = 0; offset < size; offset += PICO_PAGE_SIZE) {
+        (void)cursor[offset];
+    }
+    (void)cursor[size - 1];
+}
+
+/*
+ * Brings the code and data pages of all loaded PICOs into the working set.
+ */
+BOOL PicoManagerPrefault(PPICO_MANAGER manager) {
+    if (!manager) return FALSE;
+    
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
+        
+        if (!entry->code || (entry->flags & PICO_FLAG_LOADING)) continue;
+        
+        TouchPages(entry->code, entry->codeSize);
+        TouchPages(entry->data, entry->dataSize);
+    }
+    
+    return TRUE;
+}
+
+/* ========================================================================
+ * RESET FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Resets the data section of a loaded PICO to its freshly loaded state.
+ * Only the data side of the load is replayed; imports come from the cache
+ * captured at load time, or are resolved again if there is none.
+ */
+BOOL ResetPicoById(PPICO_MANAGER manager, DWORD id) {
+    if (!manager || id >= manager->entryCount) return FALSE;
+    
+    PPICO_ENTRY entry = &manager->entries[id];
+    if (!entry->vault || !entry->code || !entry->data) return FALSE;
+    if (!entry->imports && !manager->funcs) return FALSE;
+    
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_RESET);
+    
+    /* Tasks would see their data change under them */
+    if (!PicoEntryClaim(entry)) return PicoStatsLeave(&manager->stats, operation, FALSE);
+    
+    DWORD64 start = PicoStatsStart(&manager->stats);
+    PicoResetData(manager->funcs, entry->vault, entry->code, entry->data, entry->imports);
+    PicoStatsStop(&manager->stats, PICO_CALL_LOADER, start);
+    
+    PicoEntryUnclaim(entry);
+    
+    /* Without an import cache the reset resolves every import again */
+    if (!entry->imports) {
+        CountImportCalls(manager, entry);
+    }
+    return PicoStatsLeave(&manager->stats, operation, TRUE);
+}
+
+/*
+ * Resets the data section of a loaded PICO by name.
+ */
+BOOL ResetPicoByName(PPICO_MANAGER manager, const char* name) {
+    if (!manager || !name) return FALSE;
+    
+    PPICO_ENTRY entry = GetPicoByName(manager, name);
+    if (!entry) return FALSE;
+    
+    return ResetPicoById(manager, entry->id);
+}
+
+/* ========================================================================
+ * EXPORT LOOKUP FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Retrieves an export from a PICO module by ID.
+ */
+char* GetPicoExportById(PPICO_MANAGER manager, DWORD id, int tag) {
+    if (!manager || id >= manager->entryCount) return NULL;
+    
+    PPICO_ENTRY entry = &manager->entries[id];
+    if (!entry->vault || !entry->code) return NULL;
+    
+    if (manager->exportSlots && !manager->exportOverflow) {
+        PPICO_EXPORT_SLOT slot = ExportRegistryFind(manager, tag, entry);
+        return slot ? slot->address : NULL;
+    }
+    
+    if (entry->info && entry->info->exports) {
+        for (DWORD i = 0; i < entry->info->exportCount; i++) {
+            if (entry->info->exports[i].tag == tag) {
+                return entry->code + entry->info->exports[i].offset;
+            }
+        }
+        return NULL;
+    }
+    
+    return (char*)PicoGetExport(entry->vault, entry->code, tag);
+}
+
+/*
+ * Retrieves an export from a PICO module by name.
+ */
+char* GetPicoExportByName(PPICO_MANAGER manager, const char* name, int tag) {
+    if (!manager || !name) return NULL;
+    
+    PPICO_ENTRY entry = GetPicoByName(manager, name);
+    if (!entry || !entry->vault || !entry->code) return NULL;
+    
+    return GetPicoExportById(manager, entry->id, tag);
+}
+
+/* ========================================================================
+ * ARENA FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Allocates the manager arena as a single RW block.
+ */
+BOOL PicoManagerInitArena(PPICO_MANAGER manager, SIZE_T arenaSize) {
+    if (!manager || arenaSize == 0) return FALSE;
+    if (manager->arenaBase) return FALSE;
+    
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_ARENA);
+    manager->arenaBase = PicoMemoryReserve(manager->allocator, &manager->stats, arenaSize, PAGE_READWRITE, PICO_MEMORY_META);
+    if (!manager->arenaBase) {
+        return PicoStatsLeave(&manager->stats, operation, FALSE);
+    }
+    
+    manager->arenaSize = arenaSize;
+    manager->arenaUsed = 0;
+    return PicoStatsLeave(&manager->stats, operation, TRUE);
+}
+
+/*
+ * Carves aligned memory out of the manager arena with a bump pointer.
+ * Arena memory is freshly committed, so it is already zeroed.
+ */
+char* PicoManagerArenaAlloc(PPICO_MANAGER manager, SIZE_T size, SIZE_T alignment) {
+    if (!manager || !manager->arenaBase) return NULL;
+    if (alignment == 0 || (alignment & (alignment - 1))) return NULL;
+    
+    ULONG_PTR current = (ULONG_PTR)manager->arenaBase + manager->arenaUsed;
+    ULONG_PTR aligned = (current + alignment - 1) & ~(ULONG_PTR)(alignment - 1);
+    SIZE_T offset = aligned - (ULONG_PTR)manager->arenaBase;
+    
+    if (offset > manager->arenaSize || size > manager->arenaSize - offset) {
+        return NULL;
+    }
+    
+    manager->arenaUsed = offset + size;
+    return (char*)aligned;
+}
+
+/* ========================================================================
+ * BOOTSTRAP FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Sizes every region a manager needs from the vaults and obtains them with
+ * one reservation: code block first (so baseAddress is the reservation
+ * base), then the data slots, entry table, export registry, name index and
+ * arena.
+ */
+BOOL PicoManagerBootstrap(
+    PPICO_MANAGER manager,
+    char** vaults,
+    const char** names,
+    DWORD count,
+    DWORD entryCapacity,
+    SIZE_T finalPadding,
+    SIZE_T arenaSize
+) {
+    if (!manager || !vaults || !names || count == 0 || entryCapacity < count) return FALSE;
+    if (manager->entryCount || manager->baseAddress || manager->arenaBase) return FALSE;
+    
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_BOOTSTRAP);
+    
+    PPICO_ENTRY callerEntries = manager->entries;
+    DWORD callerCapacity = manager->entryCapacity;
+    
+    SIZE_T codeSize = 0;
+    SIZE_T dataSize = 0;
+    SIZE_T importSize = 0;
+    DWORD exportCount = 0;
+    
+    for (DWORD i = 0; i < count; i++) {
+        if (!vaults[i] || !names[i]) return PicoStatsLeave(&manager->stats, operation, FALSE);
+        
+        /* LoadPico keeps the padding after every PICO, the last one included (BlockFits) */
+        codeSize += PicoCodeSize(vaults[i]) + manager->interPicoPadding;
+        
+        dataSize += DATA_SLOT_SIZE(PicoDataSize(vaults[i]));
+        importSize += sizeof(ULONG_PTR) * PicoImportCount(vaults[i]);
+        
+        char* cursor = NULL;
+        int tag;
+        int offset;
+        while ((cursor = PicoNextExport(vaults[i], cursor, &tag, &offset)) != NULL) {
+            exportCount++;
+        }
+    }
+    
+    /* Keep the export registry at most half full */
+    DWORD slotCapacity = 2;
+    while (slotCapacity < 2 * (exportCount + 1)) {
+        slotCapacity <<= 1;
+    }
+    
+    /* The name index stays at most half full with the entry table full */
+    DWORD nameCapacity = 2;
+    while (nameCapacity < 2 * entryCapacity) {
+        nameCapacity <<= 1;
+    }
+    
+    /* Import caches are carved from the arena at load time, reserve room for them */
+    arenaSize += importSize;
+    
+    SIZE_T codeRegion = BOOTSTRAP_ALIGN(codeSize + finalPadding, PICO_PAGE_SIZE);
+    SIZE_T entryOffset = codeRegion + dataSize;
+    SIZE_T exportOffset = entryOffset + BOOTSTRAP_ALIGN(sizeof(PICO_ENTRY) * entryCapacity, PICO_CACHE_LINE);
+    SIZE_T nameOffset = exportOffset + BOOTSTRAP_ALIGN(sizeof(PICO_EXPORT_SLOT) * slotCapacity, PICO_CACHE_LINE);
+    SIZE_T arenaOffset = nameOffset + BOOTSTRAP_ALIGN(sizeof(DWORD) * nameCapacity, PICO_CACHE_LINE);
+    SIZE_T totalSize = BOOTSTRAP_ALIGN(arenaOffset + arenaSize, PICO_PAGE_SIZE);
+    
+    char* base = PicoMemoryReserve(manager->allocator, &manager->stats, totalSize, 0, PICO_MEMORY_CODE);
+    if (!base) {
+        return PicoStatsLeave(&manager->stats, operation, FALSE);
+    }
+    
+    /* Code executable, entry table, indexes and arena read-write; data slots are committed per load */
+    if (!PicoMemoryCommit(manager->allocator, &manager->stats, base, codeRegion, PAGE_EXECUTE_READWRITE, PICO_MEMORY_CODE) ||
+        !PicoMemoryCommit(manager->allocator, &manager->stats, base + entryOffset, totalSize - entryOffset, PAGE_READWRITE, PICO_MEMORY_META)) {
+        PicoMemoryRelease(manager->allocator, &manager->stats, base, totalSize, PICO_MEMORY_CODE);
+        return PicoStatsLeave(&manager->stats, operation, FALSE);
+    }
+    
+    manager->bootstrapBase = base;
+    manager->bootstrapSize = totalSize;
+    manager->baseAddress = base;
+    manager->blockSize = codeRegion;
+    manager->usedSize = 0;
+    manager->entries = (PPICO_ENTRY)(base + entryOffset);
+    manager->entryCapacity = entryCapacity;
+    manager->arenaBase = base + arenaOffset;
+    manager->arenaSize = arenaSize;
+    manager->arenaUsed = 0;
+    
+    PicoManagerInitExports(manager, (PPICO_EXPORT_SLOT)(base + exportOffset), slotCapacity);
+    PicoManagerInitNames(manager, (DWORD*)(base + nameOffset), nameCapacity);
+    
+    /* Register the PICOs, each with its data slot */
+    char* dataSlot = base + codeRegion;
+    for (DWORD i = 0; i < count; i++) {
+        if (!AddPico(manager, names[i], vaults[i])) {
+            /* Give the reservation back and leave the manager as it was handed in */
+            for (DWORD j = 0; j < manager->entryCount; j++) {
+                PicoVaultRelease(manager->entries[j].info);
+            }
+            PicoMemoryRelease(manager->allocator, &manager->stats, base, totalSize, PICO_MEMORY_CODE);
+            
+            manager->bootstrapBase = NULL;
+            manager->bootstrapSize = 0;
+            manager->baseAddress = NULL;
+            manager->blockSize = 0;
+            manager->entries = callerEntries;
+            manager->entryCount = 0;
+            manager->entryCapacity = callerCapacity;
+            manager->exportSlots = NULL;
+            manager->exportCapacity = 0;
+            manager->exportCount = 0;
+            manager->nameSlots = NULL;
+            manager->nameCapacity = 0;
+            manager->arenaBase = NULL;
+            manager->arenaSize = 0;
+            manager->arenaUsed = 0;
+            return PicoStatsLeave(&manager->stats, operation, FALSE);
+        }
+        
         PPICO_ENTRY entry = &manager->entries[i];
+        entry->dataSlot = dataSlot;
+        dataSlot += DATA_SLOT_SIZE(entry->dataSize);
+    }
+    
+    return PicoStatsLeave(&manager->stats, operation, TRUE);
+}
+
+/* ========================================================================
+ * CHECKPOINT FUNCTIONS
+ * ======================================================================== */
+
+#define CHECKPOINT_ALIGN(x) (((SIZE_T)(x) + 15) & ~(SIZE_T)15)
+
+/*
+ * Checksums a checkpoint blob as if its crc field were 0.
+ */
+static DWORD CheckpointCrc(PPICO_MANAGER manager, char* blob, SIZE_T totalSize) {
+    PICO_CHECKPOINT_HDR hdr = *(PPICO_CHECKPOINT_HDR)blob;
+    hdr.crc = 0;
+    
+    DWORD crc = PicoManagerCrc32c(manager, 0, (const char*)&hdr, sizeof(PICO_CHECKPOINT_HDR));
+    return PicoManagerCrc32c(manager, crc, blob + sizeof(PICO_CHECKPOINT_HDR), totalSize - sizeof(PICO_CHECKPOINT_HDR));
+}
+
+/*
+ * Is the range [offset, offset + size) inside a section of sectionSize bytes?
+ */
+static BOOL CheckpointInside(int offset, SIZE_T size, int sectionSize) {
+    return offset >= 0 && (SIZE_T)offset + size <= (SIZE_T)sectionSize;
+}
+
+/*
+ * Walks a vault read back from a checkpoint without leaving its recorded
+ * size: the directive stream must end in PICO_INST_COMPLETE, import names
+ * in a NUL, and every patch, copy, export and the entry point must stay
+ * inside the sections and resources they address. The size the loader
+ * would take for the vault (PicoVaultSize) must be the recorded one.
+ */
+static BOOL CheckpointVaultValid(char* vault, DWORD vaultSize) {
+    PICO_HDR* hdr = (PICO_HDR*)vault;
+    
+    if (hdr->codeLength < 0 || hdr->dataLength < 0) return FALSE;
+    if (hdr->rsrcOffset < 0 || (DWORD)hdr->rsrcOffset > vaultSize) return FALSE;
+    if (!CheckpointInside(hdr->entryAddress, 1, hdr->codeLength)) return FALSE;
+    
+    SIZE_T size = (SIZE_T)hdr->rsrcOffset;
+    PICO_CURSOR cursor;
+    
+    cursor.end = vault + vaultSize;
+    PicoCursorInit(&cursor, vault);
+    
+    while (PicoCursorNext(&cursor)) {
+        BOOL inside = TRUE;
         
-        /* If already loaded, just advance offset */
-        if (entry->code) {
-            codeOffset += entry->codeSize + manager->interPicoPadding;
-            continue;
+        if (cursor.type == PICO_INST_PATCH) {
+            BOOL code = (cursor.option == PICO_PATCH_TEXT_TEXT || cursor.option == PICO_PATCH_TEXT_BASE);
+            inside = cursor.option >= PICO_PATCH_TEXT_TEXT && cursor.option <= PICO_PATCH_BASE_BASE &&
+                     CheckpointInside(cursor.offset, sizeof(ULONG_PTR), code ? hdr->codeLength : hdr->dataLength);
+        } else if (cursor.type == PICO_INST_PATCH_FUNC) {
+            inside = CheckpointInside(cursor.offset, sizeof(ULONG_PTR), hdr->dataLength);
+        } else if (cursor.type == PICO_INST_PATCH_DIFF) {
+            inside = CheckpointInside(cursor.offset, sizeof(DWORD), hdr->codeLength);
+        } else if (cursor.type == PICO_INST_EXPORT) {
+            inside = CheckpointInside(cursor.offset, 1, hdr->codeLength);
+        } else if (cursor.type == PICO_INST_COPY) {
+            int section = (cursor.option == PICO_CONTEXT_CODE) ? hdr->codeLength : hdr->dataLength;
+            
+            inside = cursor.total >= 0 && CheckpointInside(cursor.dst_offset, cursor.total, section) &&
+                     CheckpointInside(cursor.src_offset, cursor.total, (int)(vaultSize - hdr->rsrcOffset));
+            if (inside && (SIZE_T)hdr->rsrcOffset + cursor.src_offset + cursor.total > size) {
+                size = (SIZE_T)hdr->rsrcOffset + cursor.src_offset + cursor.total;
+            }
         }
         
-        /* If no vault, skip empty entry */
-        if (!entry->vault) continue;
+        if (!inside) return FALSE;
+    }
+    
+    if (cursor.malformed || cursor.type != PICO_INST_COMPLETE) return FALSE;
+    
+    /* The cursor stops right after the directive stream */
+    if ((SIZE_T)(cursor.next - vault) > size) {
+        size = (SIZE_T)(cursor.next - vault);
+    }
+    
+    return size == vaultSize;
+}
+
+/*
+ * Checks a checkpoint blob before anything is allocated for it: header,
+ * size and checksum, then that every record, vault and image lies inside
+ * the blob, matches its vault and fits the recorded block, and that every
+ * vault is well formed within its recorded size (CheckpointVaultValid).
+ */
+static BOOL CheckpointValid(PPICO_MANAGER manager, char* blob, SIZE_T blobSize) {
+    SIZE_T headerSize = CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_HDR));
+    if (blobSize < headerSize) return FALSE;
+    
+    PPICO_CHECKPOINT_HDR hdr = (PPICO_CHECKPOINT_HDR)blob;
+    if (hdr->magic != PICO_CHECKPOINT_MAGIC || hdr->version != PICO_CHECKPOINT_VERSION) return FALSE;
+    if (hdr->pointerSize != sizeof(ULONG_PTR)) return FALSE;
+    if (hdr->totalSize < headerSize || hdr->totalSize > blobSize) return FALSE;
+    if (CheckpointCrc(manager, blob, hdr->totalSize) != hdr->crc) return FALSE;
+    if (hdr->entryCount > manager->entryCapacity || hdr->usedSize > hdr->blockSize) return FALSE;
+    
+    SIZE_T offset = headerSize;
+    
+    for (DWORD i = 0; i < hdr->entryCount; i++) {
+        if (hdr->totalSize - offset < CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_ENTRY))) return FALSE;
         
-        /* Check if there's enough space */
-        SIZE_T requiredSize = entry->codeSize + manager->interPicoPadding;
-        if (codeOffset + requiredSize + finalPadding > manager->blockSize) {
-            return FALSE;
+        PPICO_CHECKPOINT_ENTRY record = (PPICO_CHECKPOINT_ENTRY)(blob + offset);
+        offset += CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_ENTRY));
+        
+        if (record->name[PICO_NAME_MAX_LENGTH - 1] != '\0') return FALSE;
+        if (!record->vaultSize) {
+            if (record->codeOffset != PICO_CHECKPOINT_NOT_LOADED) return FALSE;
+            continue;
         }
         
-        /* Assign position in shared RWX block */
-        entry->code = manager->baseAddress + codeOffset;
+        char* vault = blob + offset;
+        if (record->vaultSize < sizeof(PICO_HDR) || hdr->totalSize - offset < CHECKPOINT_ALIGN(record->vaultSize)) return FALSE;
+        if (!CheckpointVaultValid(vault, record->vaultSize)) return FALSE;
+        offset += CHECKPOINT_ALIGN(record->vaultSize);
         
-        /* Allocate separate RW block for data section */
-        entry->data = (char*)KERNEL32$VirtualAlloc(NULL, entry->dataSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-        if (!entry->data) {
-            return FALSE;
-        }
+        if (record->codeOffset == PICO_CHECKPOINT_NOT_LOADED) continue;
         
-        /* Load the PICO */
-        PicoLoad(funcs, entry->vault, entry->code, entry->data);
+        if (record->codeSize != (SIZE_T)PicoCodeSize(vault) || record->dataSize != (SIZE_T)PicoDataSize(vault)) return FALSE;
+        if (record->codeOffset > hdr->blockSize || hdr->blockSize - record->codeOffset < record->codeSize) return FALSE;
         
-        /* Calculate entry point */
-        entry->entryPoint = (char*)PicoEntryPoint(entry->vault, entry->code);
+        SIZE_T imageSize = CHECKPOINT_ALIGN(record->codeSize) + CHECKPOINT_ALIGN(record->dataSize);
+        if (hdr->totalSize - offset < imageSize) return FALSE;
+        offset += imageSize;
+    }
+    
+    return offset == hdr->totalSize;
+}
+
+/*
+ * Gives back everything a failed restore set up, leaving the manager empty
+ * as it was handed in.
+ */
+static void RestoreUndo(PPICO_MANAGER manager, SIZE_T reserveSize) {
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
         
-        /* Advance offset for next PICO */
-        codeOffset += entry->codeSize + manager->interPicoPadding;
+        if (entry->data && !entry->dataSlot) {
+            PicoMemoryRelease(manager->allocator, &manager->stats, entry->data, entry->dataSize, PICO_MEMORY_DATA);
+        }
+        PicoVaultRelease(entry->info);
     }
+    MSVCRT$memset(manager->entries, 0, sizeof(PICO_ENTRY) * manager->entryCount);
     
-    manager->usedSize = codeOffset;
-    return TRUE;
+    if (manager->exportSlots) {
+        MSVCRT$memset(manager->exportSlots, 0, sizeof(PICO_EXPORT_SLOT) * manager->exportCapacity);
+        manager->exportCount = 0;
+        manager->exportOverflow = FALSE;
+    }
+    if (manager->nameSlots) {
+        MSVCRT$memset(manager->nameSlots, 0, sizeof(DWORD) * manager->nameCapacity);
+    }
+    for (DWORD i = 0; i < manager->boundCount; i++) {
+        manager->boundExports[i].address = NULL;
+    }
+    
+    if (manager->dataArenaBase) {
+        PicoMemoryRelease(manager->allocator, &manager->stats, manager->dataArenaBase, manager->dataArenaSize, PICO_MEMORY_DATA);
+        manager->dataArenaBase = NULL;
+        manager->dataArenaSize = 0;
+        manager->dataArenaUsed = 0;
+    }
+    PicoMemoryRelease(manager->allocator, &manager->stats, manager->baseAddress, reserveSize, PICO_MEMORY_CODE);
+    
+    manager->baseAddress = NULL;
+    manager->blockSize = 0;
+    manager->reserveSize = 0;
+    manager->usedSize = 0;
+    manager->largePageSize = 0;
+    manager->entryCount = 0;
+    manager->residentCode = 0;
+    manager->residentData = 0;
+    manager->funcs = NULL;
 }
 
-/* ========================================================================
- * EXPORT LOOKUP FUNCTIONS
- * ======================================================================== */
+/*
+ * Calculates the checkpoint blob size: header, then per entry its record,
+ * vault copy and, when loaded, code and data images.
+ */
+SIZE_T PicoManagerCheckpointSize(PPICO_MANAGER manager) {
+    if (!manager) return 0;
+    
+    SIZE_T size = CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_HDR));
+    
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
+        
+        size += CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_ENTRY));
+        if (entry->vault) {
+            size += CHECKPOINT_ALIGN(PicoVaultSize(entry->vault));
+        }
+        if (entry->code) {
+            size += CHECKPOINT_ALIGN(entry->codeSize) + CHECKPOINT_ALIGN(entry->dataSize);
+        }
+    }
+    
+    return size;
+}
 
 /*
- * Retrieves an export from a PICO module by ID.
+ * Serializes the manager. Images are stored exactly as they are in memory
+ * together with the addresses they were captured at.
  */
-char* GetPicoExportById(PPICO_MANAGER manager, DWORD id, int tag) {
-    if (!manager || id >= manager->entryCount) return NULL;
+BOOL PicoManagerCheckpoint(PPICO_MANAGER manager, char* blob, SIZE_T blobSize) {
+    if (!manager || !blob) return FALSE;
     
-    PPICO_ENTRY entry = &manager->entries[id];
-    if (!entry->vault || !entry->code) return NULL;
+    SIZE_T totalSize = PicoManagerCheckpointSize(manager);
+    if (blobSize < totalSize) return FALSE;
     
-    return (char*)PicoGetExport(entry->vault, entry->code, tag);
+    MSVCRT$memset(blob, 0, totalSize);
+    
+    PPICO_CHECKPOINT_HDR hdr = (PPICO_CHECKPOINT_HDR)blob;
+    hdr->magic = PICO_CHECKPOINT_MAGIC;
+    hdr->version = PICO_CHECKPOINT_VERSION;
+    hdr->pointerSize = sizeof(ULONG_PTR);
+    hdr->entryCount = manager->entryCount;
+    hdr->totalSize = totalSize;
+    hdr->blockSize = manager->blockSize;
+    hdr->usedSize = manager->usedSize;
+    hdr->interPicoPadding = manager->interPicoPadding;
+    hdr->oldBase = (ULONG_PTR)manager->baseAddress;
+    
+    char* cursor = blob + CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_HDR));
+    
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
+        PPICO_CHECKPOINT_ENTRY record = (PPICO_CHECKPOINT_ENTRY)cursor;
+        
+        MSVCRT$strncpy(record->name, entry->name, PICO_NAME_MAX_LENGTH - 1);
+        record->dependencies = entry->dependencies;
+        record->flags = entry->flags & (PICO_FLAG_INIT | PICO_FLAG_PINNED | PICO_FLAG_INITIALIZED);
+        record->vaultSize = entry->vault ? PicoVaultSize(entry->vault) : 0;
+        record->codeOffset = entry->code ? (SIZE_T)(entry->code - manager->baseAddress) : PICO_CHECKPOINT_NOT_LOADED;
+        record->codeSize = entry->codeSize;
+        record->dataSize = entry->dataSize;
+        record->oldData = (ULONG_PTR)entry->data;
+        cursor += CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_ENTRY));
+        
+        __movsb((unsigned char*)cursor, (unsigned char*)entry->vault, record->vaultSize);
+        cursor += CHECKPOINT_ALIGN(record->vaultSize);
+        
+        if (entry->code) {
+            __movsb((unsigned char*)cursor, (unsigned char*)entry->code, entry->codeSize);
+            cursor += CHECKPOINT_ALIGN(entry->codeSize);
+            
+            __movsb((unsigned char*)cursor, (unsigned char*)entry->data, entry->dataSize);
+            cursor += CHECKPOINT_ALIGN(entry->dataSize);
+        }
+    }
+    
+    hdr->crc = CheckpointCrc(manager, blob, totalSize);
+    return TRUE;
 }
 
 /*
- * Retrieves an export from a PICO module by name.
+ * Restores a manager from a checkpoint blob into a fresh RWX block.
+ * Entries keep their IDs and block offsets; images are rebased by delta.
+ * The blob is checked in full first, and a restore that cannot place or
+ * rebase every image is undone.
  */
-char* GetPicoExportByName(PPICO_MANAGER manager, const char* name, int tag) {
-    if (!manager || !name) return NULL;
+BOOL PicoManagerRestore(PPICO_MANAGER manager, char* blob, SIZE_T blobSize, IMPORTFUNCS * funcs) {
+    if (!manager || !blob || !funcs) return FALSE;
+    if (manager->entryCount || manager->baseAddress) return FALSE;
+    if (!CheckpointValid(manager, blob, blobSize)) return FALSE;
     
-    PPICO_ENTRY entry = GetPicoByName(manager, name);
-    if (!entry || !entry->vault || !entry->code) return NULL;
+    PPICO_CHECKPOINT_HDR hdr = (PPICO_CHECKPOINT_HDR)blob;
     
-    return (char*)PicoGetExport(entry->vault, entry->code, tag);
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_RESTORE);
+    
+    /* Size the data slots that follow the code block */
+    SIZE_T dataSize = 0;
+    char* cursor = blob + CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_HDR));
+    
+    for (DWORD i = 0; i < hdr->entryCount; i++) {
+        PPICO_CHECKPOINT_ENTRY record = (PPICO_CHECKPOINT_ENTRY)cursor;
+        cursor += CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_ENTRY));
+        
+        /* Entries without a vault keep their ID but get no slot */
+        if (record->vaultSize) {
+            dataSize += DATA_SLOT_SIZE(PicoDataSize(cursor));
+        }
+        cursor += CHECKPOINT_ALIGN(record->vaultSize);
+        
+        if (record->codeOffset != PICO_CHECKPOINT_NOT_LOADED) {
+            cursor += CHECKPOINT_ALIGN(record->codeSize) + CHECKPOINT_ALIGN(record->dataSize);
+        }
+    }
+    
+    SIZE_T blockSize = hdr->blockSize;
+    char* dataSlot;
+    manager->baseAddress = ReserveCodeBlock(manager, &blockSize, dataSize, &dataSlot);
+    if (!manager->baseAddress) {
+        return PicoStatsLeave(&manager->stats, operation, FALSE);
+    }
+    SIZE_T reserveSize = CodeReservationSize(manager);
+    
+    manager->blockSize = blockSize;
+    manager->usedSize = hdr->usedSize;
+    manager->interPicoPadding = hdr->interPicoPadding;
+    manager->funcs = funcs;
+    
+    BOOL valid = TRUE;
+    cursor = blob + CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_HDR));
+    
+    for (DWORD i = 0; i < hdr->entryCount && valid; i++) {
+        PPICO_CHECKPOINT_ENTRY record = (PPICO_CHECKPOINT_ENTRY)cursor;
+        cursor += CHECKPOINT_ALIGN(sizeof(PICO_CHECKPOINT_ENTRY));
+        
+        char* vault = cursor;
+        cursor += CHECKPOINT_ALIGN(record->vaultSize);
+        
+        /* An entry without a vault is kept empty so later IDs do not move */
+        if (!record->vaultSize) {
+            PPICO_ENTRY empty = &manager->entries[manager->entryCount];
+            MSVCRT$memset(empty, 0, sizeof(PICO_ENTRY));
+            empty->id = manager->entryCount++;
+            MSVCRT$strncpy(empty->name, record->name, PICO_NAME_MAX_LENGTH - 1);
+            empty->nameHash = PicoNameHash(empty->name);
+            NameIndexInsert(manager, empty);
+            continue;
+        }
+        
+        if (!AddPico(manager, record->name, vault)) {
+            valid = FALSE;
+            break;
+        }
+        
+        PPICO_ENTRY entry = &manager->entries[manager->entryCount - 1];
+        entry->dependencies = record->dependencies;
+        entry->flags = record->flags;
+        
+        if (dataSlot) {
+            entry->dataSlot = dataSlot;
+            dataSlot += DATA_SLOT_SIZE(entry->dataSize);
+        }
+        
+        if (record->codeOffset == PICO_CHECKPOINT_NOT_LOADED) continue;
+        
+        char* code = cursor;
+        cursor += CHECKPOINT_ALIGN(record->codeSize);
+        char* data = cursor;
+        cursor += CHECKPOINT_ALIGN(record->dataSize);
+        
+        /* A block that came back smaller or data out of reach cannot take the image */
+        if (!BlockFits(manager, record->codeOffset, entry->codeSize, 0) || !PlacePico(manager, entry, record->codeOffset)) {
+            valid = FALSE;
+            break;
+        }
+        
+        __movsb((unsigned char*)entry->code, (unsigned char*)code, entry->codeSize);
+        __movsb((unsigned char*)entry->data, (unsigned char*)data, entry->dataSize);
+        
+        /* Only the relocation deltas are applied; imports are resolved again */
+        DWORD64 start = PicoStatsStart(&manager->stats);
+        if (!PicoRebase(funcs, vault, entry->code, entry->data, (char*)(hdr->oldBase + record->codeOffset), (char*)record->oldData)) {
+            valid = FALSE;
+        }
+        PicoStatsStop(&manager->stats, PICO_CALL_LOADER, start);
+        CountImportCalls(manager, entry);
+        
+        CompletePico(manager, entry);
+    }
+    
+    if (!valid) {
+        RestoreUndo(manager, reserveSize);
+    }
+    
+    return PicoStatsLeave(&manager->stats, operation, valid);
 }
 
 /* ========================================================================
@@ -300,6 +2343,248 @@ SIZE_T TotalCodeSize(PPICO_MANAGER manager) {
     return totalSize;
 }
 
+/* ========================================================================
+ * LAYOUT FUNCTIONS
+ * ======================================================================== */
+
+typedef void (*PICO_LAYOUT_SINK)(LPVOID context, PPICO_LAYOUT_REGION region);
+
+typedef struct {
+    char* buffer;
+    SIZE_T size;
+    SIZE_T length;
+    PPICO_MANAGER manager;
+} PICO_LAYOUT_TEXT;
+
+typedef struct {
+    PPICO_LAYOUT_REGION regions;
+    DWORD capacity;
+} PICO_LAYOUT_ARRAY;
+
+/*
+ * Accounts for one region in the summary and hands it to the sink.
+ * Free and padding bytes are only counted inside the block; padding,
+ * like code, ends a free run.
+ */
+static void EmitRegion(PPICO_LAYOUT layout, PICO_LAYOUT_SINK sink, LPVOID context, PPICO_LAYOUT_REGION region, SIZE_T* run) {
+    SIZE_T inside = 0;
+    
+    if (region->offset < layout->blockSize) {
+        SIZE_T end = region->offset + region->size;
+        if (end > layout->blockSize) end = layout->blockSize;
+        inside = end - region->offset;
+    }
+    
+    if (region->type == PICO_REGION_CODE) {
+        *run = 0;
+    } else if (region->type == PICO_REGION_PADDING) {
+        layout->paddingSize += inside;
+        *run = 0;
+    } else {
+        *run += inside;
+        if (*run > layout->largestFree) layout->largestFree = *run;
+    }
+    
+    layout->regionCount++;
+    if (sink) sink(context, region);
+}
+
+/*
+ * Walks the code block in order. Loaded code is placed where it is, unloaded
+ * slots where LoadPico would put them; gaps between the two become holes.
+ */
+static void WalkLayout(PPICO_MANAGER manager, PPICO_LAYOUT layout, PICO_LAYOUT_SINK sink, LPVOID context) {
+    PICO_LAYOUT_REGION region;
+    SIZE_T cursor = 0;
+    SIZE_T slot = 0;
+    SIZE_T run = 0;
+    SIZE_T codeBytes = 0;
+    
+    layout->baseAddress = manager->baseAddress;
+    layout->blockSize = manager->blockSize;
+    layout->usedSize = manager->usedSize;
+    layout->interPicoPadding = manager->interPicoPadding;
+    layout->requiredSize = 0;
+    layout->freeSize = 0;
+    layout->largestFree = 0;
+    layout->paddingSize = 0;
+    layout->residentData = manager->residentData;
+    layout->regionCount = 0;
+    
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
+        if (!entry->vault) continue;
+        
+        SIZE_T offset = entry->code ? (SIZE_T)(entry->code - manager->baseAddress) : slot;
+        slot += entry->codeSize + manager->interPicoPadding;
+        
+        if (offset > cursor) {
+            region = (PICO_LAYOUT_REGION){ PICO_REGION_FREE, 0, 0, cursor, offset - cursor, NULL, 0 };
+            EmitRegion(layout, sink, context, &region, &run);
+        }
+        
+        region.type = entry->code ? PICO_REGION_CODE : PICO_REGION_UNLOADED;
+        region.id = i;
+        region.flags = entry->flags;
+        region.offset = offset;
+        region.size = entry->codeSize;
+        region.data = entry->code ? entry->data : NULL;
+        region.dataSize = entry->dataSize;
+        EmitRegion(layout, sink, context, &region, &run);
+        
+        if (entry->code && offset < manager->blockSize) {
+            SIZE_T end = offset + entry->codeSize;
+            codeBytes += (end > manager->blockSize ? manager->blockSize : end) - offset;
+        }
+        
+        SIZE_T end = offset + entry->codeSize;
+        if (manager->interPicoPadding) {
+            region = (PICO_LAYOUT_REGION){ PICO_REGION_PADDING, 0, 0, end, manager->interPicoPadding, NULL, 0 };
+            EmitRegion(layout, sink, context, &region, &run);
+            end += manager->interPicoPadding;
+        }
+        if (end > cursor) cursor = end;
+    }
+    
+    if (cursor < manager->blockSize) {
+        region = (PICO_LAYOUT_REGION){ PICO_REGION_FREE, 0, 0, cursor, manager->blockSize - cursor, NULL, 0 };
+        EmitRegion(layout, sink, context, &region, &run);
+    }
+    
+    layout->requiredSize = slot;
+    layout->freeSize = manager->blockSize - codeBytes;
+    layout->freeSize -= (layout->paddingSize < layout->freeSize) ? layout->paddingSize : layout->freeSize;
+}
+
+static void ArraySink(LPVOID context, PPICO_LAYOUT_REGION region) {
+    PICO_LAYOUT_ARRAY* array = (PICO_LAYOUT_ARRAY*)context;
+    
+    if (array->capacity) {
+        *array->regions++ = *region;
+        array->capacity--;
+    }
+}
+
+/*
+ * Fills the layout summary and as much of the block map as fits.
+ */
+BOOL PicoManagerLayout(PPICO_MANAGER manager, PPICO_LAYOUT layout, PPICO_LAYOUT_REGION regions, DWORD capacity) {
+    if (!manager || !layout || (!regions && capacity)) return FALSE;
+    
+    PICO_LAYOUT_ARRAY array = { regions, capacity };
+    WalkLayout(manager, layout, ArraySink, &array);
+    
+    return layout->regionCount <= capacity;
+}
+
+/*
+ * Text output helpers, counting what does not fit so the caller learns the full length.
+ */
+static void TextChar(PICO_LAYOUT_TEXT* text, char c) {
+    if (text->length + 1 < text->size) text->buffer[text->length] = c;
+    text->length++;
+}
+
+static void TextString(PICO_LAYOUT_TEXT* text, const char* string, SIZE_T max) {
+    for (SIZE_T i = 0; i < max && string[i]; i++) {
+        TextChar(text, string[i]);
+    }
+}
+
+static void TextHex(PICO_LAYOUT_TEXT* text, ULONG_PTR value) {
+    int shift = sizeof(ULONG_PTR) * 8 - 4;
+    
+    TextString(text, "0x", 2);
+    while (shift > 0 && !((value >> shift) & 0xF)) shift -= 4;
+    for (; shift >= 0; shift -= 4) {
+        TextChar(text, "0123456789abcdef"[(value >> shift) & 0xF]);
+    }
+}
+
+static void TextDecimal(PICO_LAYOUT_TEXT* text, DWORD value) {
+    char digits[10];
+    int count = 0;
+    
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (count) TextChar(text, digits[--count]);
+}
+
+static void TextSink(LPVOID context, PPICO_LAYOUT_REGION region) {
+    static const char* const types[] = { " code ", " padding ", " unloaded ", " free " };
+    PICO_LAYOUT_TEXT* text = (PICO_LAYOUT_TEXT*)context;
+    PPICO_MANAGER manager = text->manager;
+    
+    TextChar(text, '+');
+    TextHex(text, region->offset);
+    TextString(text, types[region->type], 16);
+    TextHex(text, region->size);
+    
+    if (region->type == PICO_REGION_CODE || region->type == PICO_REGION_UNLOADED) {
+        TextString(text, " #", 2);
+        TextDecimal(text, region->id);
+        if (manager->entries[region->id].name[0]) {
+            TextChar(text, ' ');
+            TextString(text, manager->entries[region->id].name, PICO_NAME_MAX_LENGTH);
+        }
+        if (region->data) {
+            TextString(text, " data ", 6);
+            TextHex(text, (ULONG_PTR)region->data);
+            TextChar(text, ' ');
+            TextHex(text, region->dataSize);
+        }
+        if (region->flags & PICO_FLAG_INIT) TextString(text, " init", 5);
+        if (region->flags & PICO_FLAG_PINNED) TextString(text, " pinned", 7);
+        if (region->flags & PICO_FLAG_LOADING) TextString(text, " loading", 8);
+        if (region->flags & PICO_FLAG_DECOMMITTED) TextString(text, " decommitted", 12);
+    }
+    
+    /* Slots that do not fit in an allocated block */
+    if (manager->baseAddress && region->offset + region->size > manager->blockSize) {
+        TextString(text, " overflow", 9);
+    }
+    TextChar(text, '\n');
+}
+
+/*
+ * Writes the summary line, then walks the block again for the region lines.
+ */
+SIZE_T PicoManagerLayoutText(PPICO_MANAGER manager, char* buffer, SIZE_T size) {
+    if (!manager || (!buffer && size)) return 0;
+    
+    PICO_LAYOUT layout;
+    PICO_LAYOUT_TEXT text = { buffer, size, 0, manager };
+    
+    WalkLayout(manager, &layout, NULL, NULL);
+    
+    TextString(&text, "block ", 6);
+    TextHex(&text, (ULONG_PTR)layout.baseAddress);
+    TextString(&text, " size ", 6);
+    TextHex(&text, layout.blockSize);
+    TextString(&text, " used ", 6);
+    TextHex(&text, layout.usedSize);
+    TextString(&text, " required ", 10);
+    TextHex(&text, layout.requiredSize);
+    TextString(&text, " free ", 6);
+    TextHex(&text, layout.freeSize);
+    TextString(&text, " largest ", 9);
+    TextHex(&text, layout.largestFree);
+    TextString(&text, " padding ", 9);
+    TextHex(&text, layout.interPicoPadding);
+    TextString(&text, " padded ", 8);
+    TextHex(&text, layout.paddingSize);
+    TextString(&text, " data ", 6);
+    TextHex(&text, layout.residentData);
+    TextChar(&text, '\n');
+    
+    WalkLayout(manager, &layout, TextSink, &text);
+    
+    if (size) buffer[text.length < size ? text.length : size - 1] = '\0';
+    return text.length;
+}
+
 /* ========================================================================
  * ADVANCED FUNCTIONS - MANAGER DUPLICATION AND LIFECYCLE
  * ======================================================================== */
@@ -320,6 +2605,10 @@ BOOL DuplicateManager(
     /* Initialize new manager */
     PicoManagerInit(newManager, entries, entryCapacity);
     newManager->interPicoPadding = manager->interPicoPadding;
+    newManager->vaultCache = manager->vaultCache;
+    newManager->blockOptions = manager->blockOptions;
+    newManager->loadParts = manager->loadParts;
+    newManager->loadThreshold = manager->loadThreshold;
     
     /* Copy all vault references from old manager */
     for (DWORD i = 0; i < manager->entryCount; i++) {
@@ -351,16 +2640,151 @@ BOOL DestroyManager(
 ) {
     if (!manager) return FALSE;
     
-    /* Free the main RWX code block */
-    if (picoBlock) {
-        KERNEL32$VirtualFree(picoBlock, 0, MEM_RELEASE);
+    /* Only the manager's own block has a size to release it with */
+    if (picoBlock && picoBlock != manager->baseAddress && picoBlock != manager->bootstrapBase) return FALSE;
+    
+    /* Workers may still run module code or read their deques in the arena */
+    if (!ClaimEntries(manager, 0, manager->entryCount)) return FALSE;
+    if (manager->executor && !PicoExecutorStop(manager)) {
+        UnclaimEntries(manager, 0, manager->entryCount);
+        return FALSE;
+    }
+    UnclaimEntries(manager, 0, manager->entryCount);
+    
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_DESTROY);
+    
+    /* Drop vault cache references held by the entries */
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        PicoVaultRelease(manager->entries[i].info);
+        manager->entries[i].info = NULL;
+    }
+    
+    /* Drop all published exports */
+    if (manager->exportSlots) {
+        MSVCRT$memset(manager->exportSlots, 0, sizeof(PICO_EXPORT_SLOT) * manager->exportCapacity);
+        manager->exportCount = 0;
+        manager->exportOverflow = FALSE;
+    }
+    if (manager->nameSlots) {
+        MSVCRT$memset(manager->nameSlots, 0, sizeof(DWORD) * manager->nameCapacity);
+    }
+    for (DWORD i = 0; i < manager->boundCount; i++) {
+        manager->boundExports[i].address = NULL;
+    }
+    
+    /* Free the main RWX code block; for a bootstrapped manager that is the whole reservation */
+    if (picoBlock && picoBlock == manager->bootstrapBase) {
+        PicoMemoryRelease(manager->allocator, &manager->stats, picoBlock, manager->bootstrapSize, PICO_MEMORY_CODE);
+        
+        manager->bootstrapBase = NULL;
+        manager->bootstrapSize = 0;
+        manager->entries = NULL;
+        manager->entryCapacity = 0;
+        manager->exportSlots = NULL;
+        manager->exportCapacity = 0;
+        manager->nameSlots = NULL;
+        manager->nameCapacity = 0;
+        manager->arenaBase = NULL;
+        manager->arenaSize = 0;
+        manager->arenaUsed = 0;
+        manager->channels = NULL;
+        manager->executorState = NULL;
+    } else if (picoBlock) {
+        PicoMemoryRelease(manager->allocator, &manager->stats, picoBlock, CodeReservationSize(manager), PICO_MEMORY_CODE);
     }
     
     /* Clear manager state (optional but good practice) */
     manager->baseAddress = NULL;
     manager->blockSize = 0;
+    manager->reserveSize = 0;
     manager->usedSize = 0;
     manager->entryCount = 0;
     
-    return TRUE;
-}
\ No newline at end of file
+    return PicoStatsLeave(&manager->stats, operation, TRUE);
+}
+
+/*
+ * Releases everything the manager owns and leaves it empty for reuse.
+ * With data sections in data slots, the memory goes back with one call per
+ * region instead of one per module.
+ */
+BOOL PicoManagerTeardown(PPICO_MANAGER manager) {
+    if (!manager) return FALSE;
+    
+    /* Workers and their channels live in the arena; with the executor gone no task can start */
+    if (!ClaimEntries(manager, 0, manager->entryCount)) return FALSE;
+    if (manager->executor && !PicoExecutorStop(manager)) {
+        UnclaimEntries(manager, 0, manager->entryCount);
+        return FALSE;
+    }
+    UnclaimEntries(manager, 0, manager->entryCount);
+    
+    DWORD operation = PicoStatsEnter(&manager->stats, PICO_OP_DESTROY);
+    
+    /* Data sections allocated one by one, then the vault cache references */
+    for (DWORD i = 0; i < manager->entryCount; i++) {
+        PPICO_ENTRY entry = &manager->entries[i];
+        
+        if (entry->data && !entry->dataSlot) {
+            PicoMemoryRelease(manager->allocator, &manager->stats, entry->data, entry->dataSize, PICO_MEMORY_DATA);
+        }
+        PicoVaultRelease(entry->info);
+    }
+    
+    /* Indexes held in caller storage are cleared, not released */
+    if (manager->exportSlots) {
+        MSVCRT$memset(manager->exportSlots, 0, sizeof(PICO_EXPORT_SLOT) * manager->exportCapacity);
+    }
+    if (manager->nameSlots) {
+        MSVCRT$memset(manager->nameSlots, 0, sizeof(DWORD) * manager->nameCapacity);
+    }
+    for (DWORD i = 0; i < manager->boundCount; i++) {
+        manager->boundExports[i].address = NULL;
+    }
+    
+    PPICO_ENTRY entries = manager->entries;
+    DWORD entryCapacity = manager->entryCapacity;
+    
+    /* Data slots outside the code reservation */
+    if (manager->dataArenaBase) {
+        PicoMemoryRelease(manager->allocator, &manager->stats, manager->dataArenaBase, manager->dataArenaSize, PICO_MEMORY_DATA);
+    }
+    
+    /* One reservation holds everything else after a bootstrap; otherwise code block and arena */
+    if (manager->bootstrapBase) {
+        PicoMemoryRelease(manager->allocator, &manager->stats, manager->bootstrapBase, manager->bootstrapSize, PICO_MEMORY_CODE);
+        entries = NULL;
+        entryCapacity = 0;
+    } else {
+        if (manager->baseAddress) {
+            PicoMemoryRelease(manager->allocator, &manager->stats, manager->baseAddress, CodeReservationSize(manager), PICO_MEMORY_CODE);
+        }
+        if (manager->arenaBase) {
+            PicoMemoryRelease(manager->allocator, &manager->stats, manager->arenaBase, manager->arenaSize, PICO_MEMORY_META);
+        }
+        if (entries) {
+            MSVCRT$memset(entries, 0, sizeof(PICO_ENTRY) * manager->entryCount);
+        }
+    }
+    
+    /* Back to a fresh manager, keeping the memory and loading setup and the statistics */
+    PPICO_ALLOCATOR allocator = manager->allocator;
+    PPICO_VAULT_CACHE vaultCache = manager->vaultCache;
+    PICO_STATS stats = manager->stats;
+    SIZE_T interPicoPadding = manager->interPicoPadding;
+    DWORD blockOptions = manager->blockOptions;
+    DWORD loadParts = manager->loadParts;
+    SIZE_T loadThreshold = manager->loadThreshold;
+    
+    PicoManagerInit(manager, entries, entryCapacity);
+    
+    manager->allocator = allocator;
+    manager->vaultCache = vaultCache;
+    manager->stats = stats;
+    manager->interPicoPadding = interPicoPadding;
+    manager->blockOptions = blockOptions;
+    manager->loadParts = loadParts;
+    manager->loadThreshold = loadThreshold;
+    
+    return PicoStatsLeave(&manager->stats, operation, TRUE);
+}
@@ -0,0 +1,228 @@
+/*
+ * PICO Manager Library - Memory
+ *
+ * Single path for every page-level allocation the library makes. Each call
+ * goes to the caller's PICO_ALLOCATOR when one is set, and to VirtualAlloc
+ * and VirtualFree otherwise. Every call is also counted in
+ * the owning manager's statistics.
+ */
+
+#include <windows.h>
+#include "../Include/PicoManager.h"
+#include "PicoInternal.h"
+
+/* ========================================================================
+ * EXTERNAL FUNCTION DECLARATIONS
+ * ======================================================================== */
+
+WINBASEAPI LPVOID WINAPI KERNEL32$VirtualAlloc(LPVOID lpAddress, SIZE_T dwSize, DWORD flAllocationType, DWORD flProtect);
+WINBASEAPI BOOL WINAPI KERNEL32$VirtualFree(LPVOID lpAddress, SIZE_T dwSize, DWORD dwFreeType);
+WINBASEAPI SIZE_T WINAPI KERNEL32$GetLargePageMinimum(void);
+DECLSPEC_IMPORT void* __cdecl MSVCRT$memset(void* dest, int c, size_t count);
+
+/* ========================================================================
+ * STATISTICS FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Reads the time stamp counter if timing is on, so untimed calls cost
+ * nothing but the counter increment.
+ */
+DWORD64 PicoStatsStart(PPICO_STATS stats) {
+    if (!stats || !stats->timing) return 0;
+    return __builtin_ia32_rdtsc();
+}
+
+/*
+ * Counts one call of the current operation and adds the ticks since start.
+ */
+void PicoStatsStop(PPICO_STATS stats, DWORD call, DWORD64 start) {
+    if (!stats) return;
+
+    stats->calls[stats->operation][call]++;
+
+    /* Timing may have been turned on between start and stop */
+    if (stats->timing && start) {
+        stats->ticks[stats->operation][call] += __builtin_ia32_rdtsc() - start;
+    }
+}
+
+/*
+ * Counts calls made where they cannot be timed on their own, such as the
+ * import calls inside a loader pass.
+ */
+void PicoStatsAdd(PPICO_STATS stats, DWORD call, DWORD count) {
+    if (!stats) return;
+
+    stats->calls[stats->operation][call] += count;
+}
+
+/*
+ * Attributes the calls that follow to an operation and returns the one
+ * they were attributed to before, so nested operations unwind cleanly.
+ */
+DWORD PicoStatsEnter(PPICO_STATS stats, DWORD operation) {
+    if (!stats) return PICO_OP_OTHER;
+
+    DWORD previous = stats->operation;
+
+    stats->operation = operation;
+    return previous;
+}
+
+/*
+ * Puts back the operation PicoStatsEnter replaced and passes the result
+ * through, so every exit of an operation can end with it.
+ */
+BOOL PicoStatsLeave(PPICO_STATS stats, DWORD previous, BOOL result) {
+    if (stats) stats->operation = previous;
+    return result;
+}
+
+/*
+ * Clears the statistics of a manager, keeping the current operation.
+ */
+BOOL PicoManagerResetStats(PPICO_MANAGER manager, BOOL timing) {
+    if (!manager) return FALSE;
+
+    DWORD operation = manager->stats.operation;
+
+    MSVCRT$memset(&manager->stats, 0, sizeof(PICO_STATS));
+    manager->stats.operation = operation;
+    manager->stats.timing = timing;
+    return TRUE;
+}
+
+/* ========================================================================
+ * ALLOCATOR DISPATCH FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Reserves a region, committing it in the same call unless protect is 0.
+ */
+char* PicoMemoryReserve(PPICO_ALLOCATOR allocator, PPICO_STATS stats, SIZE_T size, DWORD protect, DWORD kind) {
+    DWORD64 start = PicoStatsStart(stats);
+    char* address;
+
+    if (allocator) {
+        address = (char*)allocator->Reserve(allocator->context, size, protect, kind);
+    } else if (protect == 0) {
+        address = (char*)KERNEL32$VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+    } else {
+        address = (char*)KERNEL32$VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, protect);
+    }
+
+    PicoStatsStop(stats, PICO_CALL_RESERVE, start);
+    return address;
+}
+
+/*
+ * Reserves and commits a region backed by large pages, rounding *size up to
+ * the large page size. Large pages need SeLockMemoryPrivilege and enough
+ * contiguous physical memory; when they cannot be had this falls back to a
+ * normal reservation of the original size. *pageSize receives the large
+ * page size, or 0 if the region uses normal pages.
+ */
+char* PicoMemoryReserveLarge(PPICO_ALLOCATOR allocator, PPICO_STATS stats, SIZE_T* size, DWORD protect, DWORD kind, SIZE_T* pageSize) {
+    SIZE_T minimum = KERNEL32$GetLargePageMinimum();
+
+    *pageSize = 0;
+
+    if (minimum) {
+        SIZE_T rounded = (*size + minimum - 1) & ~(minimum - 1);
+        DWORD64 start = PicoStatsStart(stats);
+        char* address;
+
+        if (allocator) {
+            address = (char*)allocator->Reserve(allocator->context, rounded, protect, kind | PICO_MEMORY_LARGE);
+        } else {
+            address = (char*)KERNEL32$VirtualAlloc(NULL, rounded, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, protect);
+        }
+
+        PicoStatsStop(stats, PICO_CALL_RESERVE, start);
+
+        if (address) {
+            *size = rounded;
+            *pageSize = minimum;
+            return address;
+        }
+    }
+
+    return PicoMemoryReserve(allocator, stats, *size, protect, kind);
+}
+
+/*
+ * Commits pages inside a reserved region.
+ */
+BOOL PicoMemoryCommit(PPICO_ALLOCATOR allocator, PPICO_STATS stats, char* address, SIZE_T size, DWORD protect, DWORD kind) {
+    DWORD64 start = PicoStatsStart(stats);
+    BOOL result;
+
+    if (allocator) {
+        result = allocator->Commit(allocator->context, address, size, protect, kind);
+    } else {
+        result = KERNEL32$VirtualAlloc(address, size, MEM_COMMIT, protect) != NULL;
+    }
+
+    PicoStatsStop(stats, PICO_CALL_COMMIT, start);
+    return result;
+}
+
+/*
+ * Decommits pages, keeping the reservation.
+ */
+BOOL PicoMemoryDecommit(PPICO_ALLOCATOR allocator, PPICO_STATS stats, char* address, SIZE_T size, DWORD kind) {
+    DWORD64 start = PicoStatsStart(stats);
+    BOOL result;
+
+    if (allocator) {
+        result = allocator->Decommit(allocator->context, address, size, kind);
+    } else {
+        result = KERNEL32$VirtualFree(address, size, MEM_DECOMMIT);
+    }
+
+    PicoStatsStop(stats, PICO_CALL_DECOMMIT, start);
+    return result;
+}
+
+/*
+ * Releases a whole region obtained from PicoMemoryReserve.
+ */
+BOOL PicoMemoryRelease(PPICO_ALLOCATOR allocator, PPICO_STATS stats, char* address, SIZE_T size, DWORD kind) {
+    DWORD64 start = PicoStatsStart(stats);
+    BOOL result;
+
+    if (allocator) {
+        result = allocator->Release(allocator->context, address, size, kind);
+    } else {
+        result = KERNEL32$VirtualFree(address, 0, MEM_RELEASE);
+    }
+
+    PicoStatsStop(stats, PICO_CALL_RELEASE, start);
+    return result;
+}
+
+/*
+ * Sets the allocator a manager uses. Regions must be released by the
+ * allocator that reserved them, so this is only allowed before the manager
+ * owns any memory.
+ */
+BOOL PicoManagerSetAllocator(PPICO_MANAGER manager, PPICO_ALLOCATOR allocator) {
+    if (!manager) return FALSE;
+    if (manager->baseAddress || manager->arenaBase) return FALSE;
+    if (allocator && (!allocator->Reserve || !allocator->Commit || !allocator->Decommit || !allocator->Release)) return FALSE;
+
+    manager->allocator = allocator;
+    return TRUE;
+}
+
+/*
+ * Sets the allocator a vault cache uses for stored vaults from now on.
+ */
+BOOL PicoVaultCacheSetAllocator(PPICO_VAULT_CACHE cache, PPICO_ALLOCATOR allocator) {
+    if (!cache || cache->liveCount) return FALSE;
+    if (allocator && (!allocator->Reserve || !allocator->Commit || !allocator->Decommit || !allocator->Release)) return FALSE;
+
+    cache->allocator = allocator;
+    return TRUE;
+}
@@ -0,0 +1,470 @@
+/*
+ * PICO Manager Library - Vault Cache
+ *
+ * Keeps what is parsed out of a vault in a table shared by every entry and
+ * manager registering the same content, so duplicate registrations cost a
+ * lookup instead of a parse. Slots are probed by a fingerprint of the vault
+ * header and know their content by size and a fingerprint of the whole
+ * vault, taken once when the slot is filled. The same buffer matches by
+ * pointer; another buffer is hashed once, and only if its header collides.
+ * Slots are reference counted; vaults stored in the cache are freed with
+ * their last reference.
+ */
+
+#include <windows.h>
+#include "../Include/PicoManager.h"
+#include "PicoInternal.h"
+#include "../Include/PicoFormat.h"
+
+/* ========================================================================
+ * EXTERNAL FUNCTION DECLARATIONS
+ * ======================================================================== */
+
+DECLSPEC_IMPORT void* __cdecl MSVCRT$memset(void* dest, int c, size_t count);
+WINBASEAPI BOOL WINAPI KERNEL32$SwitchToThread(void);
+
+/* ========================================================================
+ * FINGERPRINT FUNCTIONS
+ * ======================================================================== */
+
+#define FINGERPRINT_PRIME1 0x9E3779B185EBCA87ULL
+#define FINGERPRINT_PRIME2 0xC2B2AE3D27D4EB4FULL
+#define FINGERPRINT_PRIME3 0x165667B19E3779F9ULL
+#define FINGERPRINT_PRIME4 0x85EBCA77C2B2AE63ULL
+#define FINGERPRINT_PRIME5 0x27D4EB2F165667C5ULL
+
+/* Vault buffers carry no alignment guarantee */
+typedef DWORD64 __attribute__((aligned(1), may_alias)) UNALIGNED_DWORD64;
+typedef DWORD __attribute__((aligned(1), may_alias)) UNALIGNED_DWORD;
+
+static DWORD64 Rotl64(DWORD64 value, int count) {
+    return (value << count) | (value >> (64 - count));
+}
+
+static DWORD64 FingerprintRound(DWORD64 acc, DWORD64 input) {
+    acc += input * FINGERPRINT_PRIME2;
+    acc = Rotl64(acc, 31);
+    return acc * FINGERPRINT_PRIME1;
+}
+
+static DWORD64 FingerprintMerge(DWORD64 acc, DWORD64 lane) {
+    acc ^= FingerprintRound(0, lane);
+    return acc * FINGERPRINT_PRIME1 + FINGERPRINT_PRIME4;
+}
+
+/*
+ * Computes an XXH64-style fingerprint. The bulk runs four independent lanes
+ * over 32-byte stripes so the multiplies of a stripe do not wait on each other.
+ */
+DWORD64 PicoFingerprint(const char* buffer, SIZE_T size) {
+    const unsigned char* p = (const unsigned char*)buffer;
+    const unsigned char* end = p + size;
+    DWORD64 hash;
+
+    if (!buffer) return 1;
+
+    if (size >= 32) {
+        DWORD64 lane0 = FINGERPRINT_PRIME1 + FINGERPRINT_PRIME2;
+        DWORD64 lane1 = FINGERPRINT_PRIME2;
+        DWORD64 lane2 = 0;
+        DWORD64 lane3 = 0 - FINGERPRINT_PRIME1;
+
+        for (; p + 32 <= end; p += 32) {
+            lane0 = FingerprintRound(lane0, *(const UNALIGNED_DWORD64*)(p + 0));
+            lane1 = FingerprintRound(lane1, *(const UNALIGNED_DWORD64*)(p + 8));
+            lane2 = FingerprintRound(lane2, *(const UNALIGNED_DWORD64*)(p + 16));
+            lane3 = FingerprintRound(lane3, *(const UNALIGNED_DWORD64*)(p + 24));
+        }
+
+        hash = Rotl64(lane0, 1) + Rotl64(lane1, 7) + Rotl64(lane2, 12) + Rotl64(lane3, 18);
+        hash = FingerprintMerge(hash, lane0);
+        hash = FingerprintMerge(hash, lane1);
+        hash = FingerprintMerge(hash, lane2);
+        hash = FingerprintMerge(hash, lane3);
+    } else {
+        hash = FINGERPRINT_PRIME5;
+    }
+
+    hash += (DWORD64)size;
+
+    /* Tail: 8, then 4, then single bytes */
+    for (; p + 8 <= end; p += 8) {
+        hash ^= FingerprintRound(0, *(const UNALIGNED_DWORD64*)p);
+        hash = Rotl64(hash, 27) * FINGERPRINT_PRIME1 + FINGERPRINT_PRIME4;
+    }
+    if (p + 4 <= end) {
+        hash ^= (DWORD64)(*(const UNALIGNED_DWORD*)p) * FINGERPRINT_PRIME1;
+        hash = Rotl64(hash, 23) * FINGERPRINT_PRIME2 + FINGERPRINT_PRIME3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash ^= (*p) * FINGERPRINT_PRIME5;
+        hash = Rotl64(hash, 11) * FINGERPRINT_PRIME1;
+    }
+
+    /* Final avalanche */
+    hash ^= hash >> 33;
+    hash *= FINGERPRINT_PRIME2;
+    hash ^= hash >> 29;
+    hash *= FINGERPRINT_PRIME3;
+    hash ^= hash >> 32;
+
+    /* 0 marks a free cache slot */
+    return hash ? hash : 1;
+}
+
+/* ========================================================================
+ * EXPORT STORAGE FUNCTIONS
+ * ======================================================================== */
+
+/* End of the free run list in export storage */
+#define EXPORT_RUN_NONE 0xFFFFFFFF
+
+/*
+ * Takes count records of export storage: first fit from the free runs,
+ * otherwise from the untouched end. A free run keeps its length in the tag
+ * of its first record and the index of the next run in the offset.
+ */
+static PPICO_VAULT_EXPORT ExportStorageAlloc(PPICO_VAULT_CACHE cache, DWORD count) {
+    DWORD previous = EXPORT_RUN_NONE;
+
+    if (!cache->exports) return NULL;
+    if (count == 0) return cache->exports;
+
+    for (DWORD index = cache->exportFree; index != EXPORT_RUN_NONE; index = (DWORD)cache->exports[index].offset) {
+        PPICO_VAULT_EXPORT run = &cache->exports[index];
+        DWORD length = (DWORD)run->tag;
+        DWORD next = (DWORD)run->offset;
+
+        if (length < count) {
+            previous = index;
+            continue;
+        }
+
+        /* The rest of the run stays free in its place */
+        if (length > count) {
+            cache->exports[index + count].tag = (int)(length - count);
+            cache->exports[index + count].offset = (int)next;
+            next = index + count;
+        }
+        if (previous == EXPORT_RUN_NONE) {
+            cache->exportFree = next;
+        } else {
+            cache->exports[previous].offset = (int)next;
+        }
+        return run;
+    }
+
+    if (count > cache->exportCapacity - cache->exportUsed) return NULL;
+
+    PPICO_VAULT_EXPORT records = &cache->exports[cache->exportUsed];
+    cache->exportUsed += count;
+    return records;
+}
+
+/*
+ * Gives records back to export storage. Runs are kept in address order and
+ * merged with their neighbours; the last run joins the untouched end if it
+ * reaches it.
+ */
+static void ExportStorageFree(PPICO_VAULT_CACHE cache, PPICO_VAULT_EXPORT records, DWORD count) {
+    if (!records || count == 0 || records < cache->exports || records >= cache->exports + cache->exportCapacity) return;
+
+    PPICO_VAULT_EXPORT exports = cache->exports;
+    DWORD index = (DWORD)(records - exports);
+    DWORD previous = EXPORT_RUN_NONE;
+    DWORD next = cache->exportFree;
+
+    while (next != EXPORT_RUN_NONE && next < index) {
+        previous = next;
+        next = (DWORD)exports[next].offset;
+    }
+
+    if (next != EXPORT_RUN_NONE && index + count == next) {
+        count += (DWORD)exports[next].tag;
+        next = (DWORD)exports[next].offset;
+    }
+
+    if (previous != EXPORT_RUN_NONE && previous + (DWORD)exports[previous].tag == index) {
+        exports[previous].tag += (int)count;
+        exports[previous].offset = (int)next;
+    } else {
+        exports[index].tag = (int)count;
+        exports[index].offset = (int)next;
+        if (previous == EXPORT_RUN_NONE) {
+            cache->exportFree = index;
+        } else {
+            exports[previous].offset = (int)index;
+        }
+    }
+
+    previous = EXPORT_RUN_NONE;
+    for (index = cache->exportFree; (DWORD)exports[index].offset != EXPORT_RUN_NONE; index = (DWORD)exports[index].offset) {
+        previous = index;
+    }
+    if (index + (DWORD)exports[index].tag == cache->exportUsed) {
+        cache->exportUsed = index;
+        if (previous == EXPORT_RUN_NONE) {
+            cache->exportFree = EXPORT_RUN_NONE;
+        } else {
+            exports[previous].offset = (int)EXPORT_RUN_NONE;
+        }
+    }
+}
+
+/* ========================================================================
+ * VAULT CACHE FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Initializes a vault cache over caller-provided storage.
+ */
+BOOL PicoVaultCacheInit(PPICO_VAULT_CACHE cache, PPICO_VAULT_INFO slots, DWORD slotCapacity, PPICO_VAULT_EXPORT exports, DWORD exportCapacity) {
+    if (!cache || !slots) return FALSE;
+    if (slotCapacity < 2 || (slotCapacity & (slotCapacity - 1))) return FALSE;
+
+    MSVCRT$memset(slots, 0, sizeof(PICO_VAULT_INFO) * slotCapacity);
+
+    cache->slots = slots;
+    cache->slotCapacity = slotCapacity;
+    cache->slotCount = 0;
+    cache->liveCount = 0;
+    cache->exports = exports;
+    cache->exportCapacity = exports ? exportCapacity : 0;
+    cache->exportUsed = 0;
+    cache->exportFree = EXPORT_RUN_NONE;
+    cache->lock = 0;
+    cache->allocator = NULL;
+    return TRUE;
+}
+
+/*
+ * Attaches a vault cache to a manager.
+ */
+BOOL PicoManagerSetVaultCache(PPICO_MANAGER manager, PPICO_VAULT_CACHE cache) {
+    if (!manager) return FALSE;
+
+    manager->vaultCache = cache;
+    return TRUE;
+}
+
+static void VaultCacheLock(PPICO_VAULT_CACHE cache) {
+    while (__atomic_exchange_n(&cache->lock, 1, __ATOMIC_ACQUIRE)) {
+        KERNEL32$SwitchToThread();
+    }
+}
+
+static void VaultCacheUnlock(PPICO_VAULT_CACHE cache) {
+    __atomic_store_n(&cache->lock, 0, __ATOMIC_RELEASE);
+}
+
+/*
+ * Parses a vault into a free or released cache slot: sizes, import count and
+ * export index. A stored vault is copied into one allocation together with
+ * its export index; otherwise the index comes from the shared export storage
+ * and is left out when that is exhausted.
+ */
+static BOOL VaultCacheFill(PPICO_VAULT_CACHE cache, PPICO_VAULT_INFO info, char* vault, DWORD vaultSize, DWORD64 key, DWORD64 fingerprint, BOOL owned) {
+    char* cursor = NULL;
+    DWORD exportCount = 0;
+    int tag;
+    int offset;
+
+    while ((cursor = PicoNextExport(vault, cursor, &tag, &offset)) != NULL) {
+        exportCount++;
+    }
+
+    info->exports = NULL;
+    info->exportCount = 0;
+    info->storedSize = 0;
+
+    if (owned) {
+        SIZE_T indexOffset = ((SIZE_T)vaultSize + 7) & ~(SIZE_T)7;
+        SIZE_T storedSize = indexOffset + sizeof(PICO_VAULT_EXPORT) * exportCount;
+        char* buffer = PicoMemoryReserve(cache->allocator, NULL, storedSize, PAGE_READWRITE, PICO_MEMORY_META);
+        if (!buffer) return FALSE;
+
+        info->storedSize = storedSize;
+        __movsb((unsigned char*)buffer, (unsigned char*)vault, vaultSize);
+        vault = buffer;
+        info->exports = (PPICO_VAULT_EXPORT)(buffer + indexOffset);
+    } else {
+        info->exports = ExportStorageAlloc(cache, exportCount);
+    }
+
+    if (info->exports) {
+        while ((cursor = PicoNextExport(vault, cursor, &tag, &offset)) != NULL) {
+            info->exports[info->exportCount].tag = tag;
+            info->exports[info->exportCount].offset = offset;
+            info->exportCount++;
+        }
+    }
+
+    info->vault = vault;
+    info->cache = cache;
+    info->references = 0;
+    info->owned = owned;
+    info->vaultSize = vaultSize;
+    info->codeSize = PicoCodeSize(vault);
+    info->dataSize = PicoDataSize(vault);
+    info->importCount = PicoImportCount(vault);
+
+    int libraries;
+    int procedures;
+    PicoResolveCount(vault, &libraries, &procedures);
+    info->libraryCount = libraries;
+    info->procedureCount = procedures;
+
+    info->key = key;
+    info->fingerprint = fingerprint;
+    return TRUE;
+}
+
+/*
+ * Sizes and fingerprints the content of a vault, at most once per lookup;
+ * *vaultSize stays 0 until then.
+ */
+static void VaultContent(char* vault, DWORD* vaultSize, DWORD64* fingerprint) {
+    if (*vaultSize) return;
+
+    *vaultSize = (DWORD)PicoVaultSize(vault);
+    *fingerprint = PicoFingerprint(vault, *vaultSize);
+}
+
+/*
+ * Finds the slot holding a vault's content. A header key match is the same
+ * buffer, or the same content when size and content fingerprint agree;
+ * those are worked out on the first such collision. If there is no match,
+ * *insert receives the first released slot along the probe sequence or,
+ * when there is room, the free slot that ended it.
+ */
+static PPICO_VAULT_INFO VaultCacheFind(PPICO_VAULT_CACHE cache, char* vault, DWORD* vaultSize, DWORD64* fingerprint, DWORD64 key, PPICO_VAULT_INFO* insert) {
+    DWORD mask = cache->slotCapacity - 1;
+    DWORD i = (DWORD)(key ^ (key >> 32)) & mask;
+
+    *insert = NULL;
+
+    for (; cache->slots[i].key; i = (i + 1) & mask) {
+        PPICO_VAULT_INFO slot = &cache->slots[i];
+
+        /* Released slots keep their key so probe sequences stay intact */
+        if (!slot->vault) {
+            if (!*insert) *insert = slot;
+            continue;
+        }
+
+        if (slot->key != key) continue;
+        if (slot->vault == vault) return slot;
+        
+        VaultContent(vault, vaultSize, fingerprint);
+        if (slot->vaultSize == *vaultSize && slot->fingerprint == *fingerprint) {
+            return slot;
+        }
+    }
+
+    /* Always keep one free slot so probe sequences terminate */
+    if (!*insert && cache->slotCount + 1 < cache->slotCapacity) {
+        *insert = &cache->slots[i];
+    }
+
+    return NULL;
+}
+
+/*
+ * Finds or inserts the slot of a vault, copying it into the cache when
+ * store is set. Takes a reference on the slot.
+ */
+static PPICO_VAULT_INFO VaultCacheAcquire(PPICO_VAULT_CACHE cache, char* vault, BOOL store) {
+    DWORD64 key = PicoFingerprint(vault, sizeof(PICO_HDR));
+    DWORD64 fingerprint = 0;
+    DWORD vaultSize = 0;
+    PPICO_VAULT_INFO insert;
+
+    VaultCacheLock(cache);
+
+    PPICO_VAULT_INFO info = VaultCacheFind(cache, vault, &vaultSize, &fingerprint, key, &insert);
+
+    if (!info && insert) {
+        BOOL fresh = (insert->key == 0);
+
+        VaultContent(vault, &vaultSize, &fingerprint);
+        if (VaultCacheFill(cache, insert, vault, vaultSize, key, fingerprint, store)) {
+            info = insert;
+            cache->liveCount++;
+            if (fresh) cache->slotCount++;
+        }
+    } else if (info && store && !info->owned) {
+        /* Content registered by pointer so far: take over a copy of it */
+        vaultSize = info->vaultSize;
+        char* buffer = PicoMemoryReserve(cache->allocator, NULL, vaultSize, PAGE_READWRITE, PICO_MEMORY_META);
+        if (buffer) {
+            __movsb((unsigned char*)buffer, (unsigned char*)vault, vaultSize);
+            info->vault = buffer;
+            info->owned = TRUE;
+            info->storedSize = vaultSize;
+        } else {
+            info = NULL;
+        }
+    }
+
+    if (info) {
+        info->references++;
+    }
+
+    VaultCacheUnlock(cache);
+    return info;
+}
+
+/*
+ * Finds the cache slot of a vault's content, inserting it on first sight.
+ */
+PPICO_VAULT_INFO PicoVaultCacheLookup(PPICO_VAULT_CACHE cache, char* vault) {
+    if (!cache || !vault) return NULL;
+
+    return VaultCacheAcquire(cache, vault, FALSE);
+}
+
+/*
+ * Stores a copy of a vault in the cache.
+ */
+PPICO_VAULT_INFO PicoVaultStorePut(PPICO_VAULT_CACHE cache, char* vault) {
+    if (!cache || !vault) return NULL;
+
+    return VaultCacheAcquire(cache, vault, TRUE);
+}
+
+/*
+ * Drops a reference. The last one frees a stored vault and its export
+ * index, and leaves the slot released for reuse.
+ */
+void PicoVaultRelease(PPICO_VAULT_INFO info) {
+    if (!info || !info->cache) return;
+
+    PPICO_VAULT_CACHE cache = info->cache;
+
+    VaultCacheLock(cache);
+
+    if (info->vault && info->references && --info->references == 0) {
+        /* A vault taken over by the store keeps the index it had in export storage */
+        ExportStorageFree(cache, info->exports, info->exportCount);
+        if (info->owned) {
+            PicoMemoryRelease(cache->allocator, NULL, info->vault, info->storedSize, PICO_MEMORY_META);
+        }
+
+        info->vault = NULL;
+        info->owned = FALSE;
+        info->storedSize = 0;
+        info->exports = NULL;
+        info->exportCount = 0;
+
+        /* An empty cache starts over without released slots */
+        if (--cache->liveCount == 0) {
+            MSVCRT$memset(cache->slots, 0, sizeof(PICO_VAULT_INFO) * cache->slotCapacity);
+            cache->slotCount = 0;
+            cache->exportUsed = 0;
+            cache->exportFree = EXPORT_RUN_NONE;
+        }
+    }
+
+    VaultCacheUnlock(cache);
+}
@@ -29,80 +29,47 @@
 #include <windows.h>
 
 #include "../Include/PicoManager.h"
-
-typedef struct {
-	int codeLength;
-	int dataLength;
-	int rsrcOffset;
-	int entryAddress;
-} PICO_HDR;
-
-#define FIRST_PICO_DIRECTIVE(x) (PICO_DIRECTIVE_HDR *)((void *)x + sizeof(PICO_HDR))
-#define NEXT_PICO_DIRECTIVE(x)  (PICO_DIRECTIVE_HDR *)((void *)x + x->length);
-
-#define PICO_INST_COMPLETE   0x0
-#define PICO_INST_PATCH      0x1
-#define PICO_INST_COPY       0x2
-#define PICO_INST_LL         0x3
-#define PICO_INST_GPA        0x4
-#define PICO_INST_PATCH_DIFF 0x5
-#define PICO_INST_PATCH_FUNC 0x6
-#define PICO_INST_EXPORT     0x7
-
-#define PICO_PATCH_TEXT_TEXT 0x0
-#define PICO_PATCH_TEXT_BASE 0x1
-#define PICO_PATCH_BASE_TEXT 0x2
-#define PICO_PATCH_BASE_BASE 0x3
-
-#define PICO_PATCHF_FUNC     0x0
-
-#define PICO_CONTEXT_CODE    0x5
-#define PICO_CONTEXT_DATA    0x6
-
-typedef struct {
-	char  type;
-	char  option;
-	short length;
-} PICO_DIRECTIVE_HDR;
-
-typedef struct {
-	PICO_DIRECTIVE_HDR hdr;
-	int offset;
-} PICO_DIRECTIVE_PATCH;
-
-typedef struct {
-	PICO_DIRECTIVE_HDR hdr;
-	int src_offset;
-	int dst_offset;
-	int total;
-} PICO_DIRECTIVE_COPY;
-
-typedef struct {
-	PICO_DIRECTIVE_HDR hdr;
-	int tag;
-	int offset;
-} PICO_DIRECTIVE_EXPORT;
+#include "PicoInternal.h"
+#include "../Include/PicoFormat.h"
+#include "../Include/PicoCursor.h"
 
 typedef void (*PICOMAIN_FUNC)(char * arg);
 
 PICOMAIN_FUNC PicoGetExport(char * src, char * base, int tag) {
-	PICO_DIRECTIVE_HDR    * entry;
-	PICO_DIRECTIVE_EXPORT * export;
-	PICO_HDR              * hdr = (PICO_HDR *)src;
+	PICO_CURSOR entry;
 
-	entry = FIRST_PICO_DIRECTIVE(hdr);
-	while (TRUE) {
-		if (entry->type == PICO_INST_EXPORT) {
-			export = (PICO_DIRECTIVE_EXPORT *)entry;
-			if (export->tag == tag)
-				return (PICOMAIN_FUNC)( base + export->offset );
-		}
-		else if (entry->type == PICO_INST_COMPLETE) {
-			return NULL;
-		}
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_EXPORT && entry.tag == tag)
+			return (PICOMAIN_FUNC)( base + entry.offset );
+	}
+
+	return NULL;
+}
+
+/*
+ * Walk the export directives of a PICO one at a time. Pass NULL as the cursor to start at the
+ * top and the returned cursor to continue. Returns NULL once the directive stream is complete.
+ * Compact vaults keep every export in a record of its own, so the cursor is always a record.
+ */
+char * PicoNextExport(char * src, char * cursor, int * tag, int * offset) {
+	PICO_CURSOR entry;
 
-		entry = NEXT_PICO_DIRECTIVE(entry);
+	PicoCursorInit(&entry, src);
+	if (cursor != NULL) {
+		entry.next = cursor;
+		PicoCursorNext(&entry);
 	}
+
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_EXPORT) {
+			*tag    = entry.tag;
+			*offset = entry.offset;
+			return entry.record;
+		}
+	}
+
+	return NULL;
 }
 
 PICOMAIN_FUNC PicoEntryPoint(char * src, char * base) {
@@ -119,47 +86,44 @@ int PicoDataSize(char * src) {
 }
 
 void PicoLoad(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData) {
-	PICO_DIRECTIVE_HDR   * entry;
-	PICO_DIRECTIVE_PATCH * patch;
-	PICO_DIRECTIVE_COPY  * copy;
-	HANDLE                 module;
-	char                 * address;
-	PICO_HDR             * hdr = (PICO_HDR *)src;
-
-	entry = FIRST_PICO_DIRECTIVE(hdr);
-	while (TRUE) {
+	PICO_CURSOR   entry;
+	HANDLE        module;
+	char        * address;
+	PICO_HDR    * hdr = (PICO_HDR *)src;
+
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
 		/*
 		 * The heart and soul of PICO loading. Patching pointers into our destination blob
 		 * to make sure everything works as hoped and expected. x86 doesn't do indirect addressing
 		 * so there's a lot more patches there. But x64 needs some pointer patching too.
 		 */
-		if (entry->type == PICO_INST_PATCH) {
+		if (entry.type == PICO_INST_PATCH) {
 			ULONG_PTR   value;
 			ULONG_PTR   src;
-			patch = (PICO_DIRECTIVE_PATCH *)entry;
 
-			if (entry->option == PICO_PATCH_TEXT_TEXT) {
+			if (entry.option == PICO_PATCH_TEXT_TEXT) {
 				src   = (ULONG_PTR)dstCode;
 				value = (ULONG_PTR)dstCode;
 			}
-			else if (entry->option == PICO_PATCH_TEXT_BASE) {
+			else if (entry.option == PICO_PATCH_TEXT_BASE) {
 				src   = (ULONG_PTR)dstCode;
 				value = (ULONG_PTR)dstData;
 			}
-			else if (entry->option == PICO_PATCH_BASE_TEXT) {
+			else if (entry.option == PICO_PATCH_BASE_TEXT) {
 				src   = (ULONG_PTR)dstData;
 				value = (ULONG_PTR)dstCode;
 			}
-			else if (entry->option == PICO_PATCH_BASE_BASE) {
+			else if (entry.option == PICO_PATCH_BASE_BASE) {
 				src   = (ULONG_PTR)dstData;
 				value = (ULONG_PTR)dstData;
 			}
 
 			/* get the existing offset (from whatever base) within the .text section */
-			value += *(ULONG_PTR *)(src + patch->offset);
+			value += *(ULONG_PTR *)(src + entry.offset);
 
 			/* set it back */
-			*(ULONG_PTR *)(src + patch->offset) = value;
+			*(ULONG_PTR *)(src + entry.offset) = value;
 		}
 		/*
 		 * This block is for updating our function table sitting in our data section. We're
@@ -167,36 +131,34 @@ void PicoLoad(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData) {
 		 * a pre-determined internal API (which is presumed to be an overloaded IMPORTFUNCS
 		 * structure... which we're treating as an array of function pointers basically)
 		 */
-		else if (entry->type == PICO_INST_PATCH_FUNC) {
+		else if (entry.type == PICO_INST_PATCH_FUNC) {
 			ULONG_PTR value;
-			patch = (PICO_DIRECTIVE_PATCH *)entry;
 
-			if (entry->option == PICO_PATCHF_FUNC) {
+			if (entry.option == PICO_PATCHF_FUNC) {
 				value = (ULONG_PTR)address;
 			}
 			else {
 				ULONG_PTR * table = (ULONG_PTR *)funcs;
-				value = table[entry->option - 1];
+				value = table[entry.option - 1];
 			}
 
-			*(ULONG_PTR *)(dstData + patch->offset) = value;
+			*(ULONG_PTR *)(dstData + entry.offset) = value;
 		}
 		/*
 		 * This is here to support keeping code + data in separate regions in x64 builds.
 		 */
 #ifdef WIN_X64
-		else if (entry->type == PICO_INST_PATCH_DIFF) {
+		else if (entry.type == PICO_INST_PATCH_DIFF) {
 			DWORD value;
-			patch = (PICO_DIRECTIVE_PATCH *)entry;
 
 			/* fetch the value currently at the patch address */
-			value   = *(DWORD *)(dstCode + patch->offset);
+			value   = *(DWORD *)(dstCode + entry.offset);
 
 			/* adjust the value */
 			value  += (ULONG_PTR)dstData - (ULONG_PTR)dstCode;
 
 			/* set it back */
-			*(DWORD *)(dstCode + patch->offset) = value;
+			*(DWORD *)(dstCode + entry.offset) = value;
 		}
 #endif
 		/*
@@ -204,42 +166,507 @@ void PicoLoad(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData) {
 		 * our .text section to pack down to its raw value and we expand it to its page-aligned
 		 * size after.
 		 */
-		else if (entry->type == PICO_INST_COPY) {
-			copy  = (PICO_DIRECTIVE_COPY *)entry;
+		else if (entry.type == PICO_INST_COPY) {
 			char * dst;
 
 			/* make sure we're copying to the right context */
-			if (entry->option == PICO_CONTEXT_CODE)
+			if (entry.option == PICO_CONTEXT_CODE)
 				dst = dstCode;
 			else
 				dst = dstData;
 
 			/* do our copy */
-			__movsb((unsigned char *)dst + copy->dst_offset, (unsigned char *)src + hdr->rsrcOffset + copy->src_offset, copy->total);
+			__movsb((unsigned char *)dst + entry.dst_offset, (unsigned char *)src + hdr->rsrcOffset + entry.src_offset, entry.total);
 		}
 		/*
 		 * Directive does a LoadLibraryA() to set our handle. Used as a precursor to any
 		 * GetProcAddress lookups based on this later on.
 		 */
-		else if (entry->type == PICO_INST_LL) {
-			char * arg = (char *)entry + sizeof(PICO_DIRECTIVE_HDR);
-			module = funcs->LoadLibraryA(arg);
+		else if (entry.type == PICO_INST_LL) {
+			module = funcs->LoadLibraryA(entry.arg);
 		}
 		/*
 		 * Call GetProcAddress on an argument. A precursor to a PATCH_FUNC instruction to push
 		 * this pointer to the appropriate spot within our PICO blob.
 		 */
-		else if (entry->type == PICO_INST_GPA) {
-			char * arg = (char *)entry + sizeof(PICO_DIRECTIVE_HDR);
-			address = (char *)funcs->GetProcAddress(module, arg);
+		else if (entry.type == PICO_INST_GPA) {
+			address = (char *)funcs->GetProcAddress(module, entry.arg);
 		}
-		/*
-		 * An instruction to indicate the loading is complete and we should return.
-		 */
-		else if (entry->type == PICO_INST_COMPLETE) {
-			return;
+	}
+}
+
+/*
+ * Count the bytes the copy directives of a PICO move, the bulk of the work PicoLoad does.
+ */
+int PicoCopySize(char * src) {
+	PICO_CURSOR entry;
+	int         size = 0;
+
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_COPY)
+			size += entry.total;
+	}
+
+	return size;
+}
+
+/*
+ * Size the phases of a PICO for a load in parts. Parts only do what PicoLoad does when no copy
+ * lands on bytes a patch or the function table already touched, which holds when every COPY
+ * comes before the first PATCH, PATCH_DIFF and PATCH_FUNC. Returns FALSE if it does not, and
+ * the PICO has to be loaded whole.
+ */
+BOOL PicoSplitCount(char * src, int * copyBytes, int * patches) {
+	PICO_CURSOR entry;
+	BOOL        patched = FALSE;
+
+	*copyBytes = 0;
+	*patches   = 0;
+
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_COPY) {
+			if (patched)
+				return FALSE;
+
+			*copyBytes += entry.total;
+		}
+		else if (entry.type == PICO_INST_PATCH || entry.type == PICO_INST_PATCH_DIFF) {
+			patched = TRUE;
+			(*patches)++;
+		}
+		else if (entry.type == PICO_INST_PATCH_FUNC) {
+			patched = TRUE;
+		}
+	}
+
+	return TRUE;
+}
+
+/*
+ * Cut the copy and patch phases of a PICO into parts equal shares each, in one walk of the
+ * directive stream. Copies are split by bytes and PATCH/PATCH_DIFF directives by count, so parts
+ * of one phase never write the same bytes. ranges[part] gets the copy share of a part and
+ * ranges[parts + part] its patch share, each with the walk state of the directive it starts at.
+ * The sizes come from PicoSplitCount.
+ */
+void PicoLoadSplit(char * src, int copyBytes, int patches, int parts, PICO_LOAD_RANGE * ranges) {
+	PICO_CURSOR   entry;
+	long long     position[2] = { 0, 0 };
+	long long     total[2]    = { copyBytes, patches };
+	int           next[2]     = { 0, 0 };
+
+	/* shares nobody reaches in the walk stay empty */
+	for (int i = 0; i < 2 * parts; i++) {
+		ranges[i].next     = NULL;
+		ranges[i].position = 0;
+		ranges[i].first    = total[i / parts] * (i % parts) / parts;
+		ranges[i].last     = total[i / parts] * (i % parts + 1) / parts;
+	}
+
+	PicoCursorInit(&entry, src);
+	while (TRUE) {
+		char * at        = entry.next;
+		int    remaining = entry.remaining;
+		int    type      = entry.type;
+		int    option    = entry.option;
+		int    offset    = entry.offset;
+		int    phase;
+		int    units;
+
+		if (!PicoCursorNext(&entry))
+			break;
+
+		if (entry.type == PICO_INST_COPY) {
+			phase = PICO_LOAD_COPY;
+			units = entry.total;
+		}
+		else if (entry.type == PICO_INST_PATCH || entry.type == PICO_INST_PATCH_DIFF) {
+			phase = PICO_LOAD_PATCH;
+			units = 1;
+		}
+		else {
+			continue;
+		}
+
+		/* every share whose first unit falls into this directive starts here */
+		while (next[phase] < parts && ranges[phase * parts + next[phase]].first < position[phase] + units) {
+			PICO_LOAD_RANGE * range = &ranges[phase * parts + next[phase]++];
+
+			range->next      = at;
+			range->remaining = remaining;
+			range->type      = type;
+			range->option    = option;
+			range->offset    = offset;
+			range->position  = position[phase];
+		}
+
+		position[phase] += units;
+	}
+}
+
+/*
+ * Load one part of a PICO, so several threads can share the work of a big one. Running every
+ * part of PICO_LOAD_COPY, then every part of PICO_LOAD_PATCH, then PICO_LOAD_IMPORTS does what
+ * PicoLoad does, for a PICO PicoSplitCount accepts. A part starts at the directive its range
+ * from PicoLoadSplit points at and stops at the end of its share. Imports stay in directive
+ * order and are not split (range is not used).
+ */
+void PicoLoadPart(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData, int phase, PICO_LOAD_RANGE * range) {
+	PICO_CURSOR   entry;
+	HANDLE        module  = NULL;
+	char        * address = NULL;
+	PICO_HDR    * hdr = (PICO_HDR *)src;
+	long long     position;
+
+	PicoCursorInit(&entry, src);
+
+	if (phase == PICO_LOAD_IMPORTS) {
+		while (PicoCursorNext(&entry)) {
+			if (entry.type == PICO_INST_PATCH_FUNC) {
+				ULONG_PTR value;
+
+				if (entry.option == PICO_PATCHF_FUNC) {
+					value = (ULONG_PTR)address;
+				}
+				else {
+					ULONG_PTR * table = (ULONG_PTR *)funcs;
+					value = table[entry.option - 1];
+				}
+
+				*(ULONG_PTR *)(dstData + entry.offset) = value;
+			}
+			else if (entry.type == PICO_INST_LL) {
+				module = funcs->LoadLibraryA(entry.arg);
+			}
+			else if (entry.type == PICO_INST_GPA) {
+				address = (char *)funcs->GetProcAddress(module, entry.arg);
+			}
+		}
+		return;
+	}
+
+	if (range->next == NULL)
+		return;
+
+	/* pick the walk up where our share starts */
+	entry.next      = range->next;
+	entry.remaining = range->remaining;
+	entry.type      = range->type;
+	entry.option    = range->option;
+	entry.offset    = range->offset;
+	position        = range->position;
+
+	while (position < range->last && PicoCursorNext(&entry)) {
+		if (phase == PICO_LOAD_COPY && entry.type == PICO_INST_COPY) {
+			char      * dst   = (entry.option == PICO_CONTEXT_CODE) ? dstCode : dstData;
+			long long   start = (position > range->first) ? position : range->first;
+			long long   end   = (position + entry.total < range->last) ? position + entry.total : range->last;
+
+			/* only the bytes of this copy that fall into our share */
+			if (start < end)
+				__movsb((unsigned char *)dst + entry.dst_offset + (start - position), (unsigned char *)src + hdr->rsrcOffset + entry.src_offset + (start - position), end - start);
+
+			position += entry.total;
+		}
+		else if (phase == PICO_LOAD_PATCH && (entry.type == PICO_INST_PATCH || entry.type == PICO_INST_PATCH_DIFF)) {
+			if (entry.type == PICO_INST_PATCH) {
+				char    * base  = (entry.option == PICO_PATCH_TEXT_TEXT || entry.option == PICO_PATCH_TEXT_BASE) ? dstCode : dstData;
+				ULONG_PTR value = (entry.option == PICO_PATCH_TEXT_TEXT || entry.option == PICO_PATCH_BASE_TEXT) ? (ULONG_PTR)dstCode : (ULONG_PTR)dstData;
+
+				*(ULONG_PTR *)(base + entry.offset) += value;
+			}
+#ifdef WIN_X64
+			else {
+				*(DWORD *)(dstCode + entry.offset) += (DWORD)((ULONG_PTR)dstData - (ULONG_PTR)dstCode);
+			}
+#endif
+
+			position++;
+		}
+	}
+}
+
+/*
+ * Count the PATCH_FUNC directives of a PICO, i.e. the function table slots in its data section.
+ */
+int PicoImportCount(char * src) {
+	PICO_CURSOR entry;
+	int         count = 0;
+
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_PATCH_FUNC)
+			count++;
+	}
+
+	return count;
+}
+
+/*
+ * Snapshot the function table slots PicoLoad just filled in, in directive order. Call this
+ * right after PicoLoad, before the PICO gets a chance to touch its own data.
+ */
+void PicoCaptureImports(char * src, char * dstData, ULONG_PTR * slots) {
+	PICO_CURSOR entry;
+
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_PATCH_FUNC)
+			*slots++ = *(ULONG_PTR *)(dstData + entry.offset);
+	}
+}
+
+/*
+ * Put the data section of a loaded PICO back into its freshly loaded state. Only the data side
+ * of PicoLoad is replayed: zero fill, data copies, BASE_* patches and the function table. The
+ * function table comes from slots captured with PicoCaptureImports or, if slots is NULL, is
+ * resolved again through funcs. Code is not touched.
+ */
+void PicoResetData(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData, ULONG_PTR * slots) {
+	PICO_CURSOR   entry;
+	HANDLE        module  = NULL;
+	char        * address = NULL;
+	PICO_HDR    * hdr = (PICO_HDR *)src;
+
+	/* a fresh data section is all zeroes */
+	__stosb((unsigned char *)dstData, 0, hdr->dataLength);
+
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_PATCH && (entry.option == PICO_PATCH_BASE_TEXT || entry.option == PICO_PATCH_BASE_BASE)) {
+			ULONG_PTR value = (entry.option == PICO_PATCH_BASE_TEXT) ? (ULONG_PTR)dstCode : (ULONG_PTR)dstData;
+			*(ULONG_PTR *)(dstData + entry.offset) += value;
+		}
+		else if (entry.type == PICO_INST_PATCH_FUNC) {
+			ULONG_PTR value;
+
+			if (slots != NULL) {
+				value = *slots++;
+			}
+			else if (entry.option == PICO_PATCHF_FUNC) {
+				value = (ULONG_PTR)address;
+			}
+			else {
+				ULONG_PTR * table = (ULONG_PTR *)funcs;
+				value = table[entry.option - 1];
+			}
+
+			*(ULONG_PTR *)(dstData + entry.offset) = value;
+		}
+		else if (entry.type == PICO_INST_COPY && entry.option != PICO_CONTEXT_CODE) {
+			__movsb((unsigned char *)dstData + entry.dst_offset, (unsigned char *)src + hdr->rsrcOffset + entry.src_offset, entry.total);
+		}
+		else if (entry.type == PICO_INST_LL && slots == NULL) {
+			module = funcs->LoadLibraryA(entry.arg);
+		}
+		else if (entry.type == PICO_INST_GPA && slots == NULL) {
+			address = (char *)funcs->GetProcAddress(module, entry.arg);
+		}
+	}
+}
+
+/*
+ * Put the code section of a loaded PICO back into its freshly loaded state, the counterpart of
+ * PicoResetData: zero fill, code copies and the TEXT_* and PATCH_DIFF patches. The data section
+ * and the function table in it are not touched.
+ */
+void PicoLoadCode(char * src, char * dstCode, char * dstData) {
+	PICO_CURSOR   entry;
+	PICO_HDR    * hdr = (PICO_HDR *)src;
+
+	__stosb((unsigned char *)dstCode, 0, hdr->codeLength);
+
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_PATCH && (entry.option == PICO_PATCH_TEXT_TEXT || entry.option == PICO_PATCH_TEXT_BASE)) {
+			ULONG_PTR value = (entry.option == PICO_PATCH_TEXT_TEXT) ? (ULONG_PTR)dstCode : (ULONG_PTR)dstData;
+			*(ULONG_PTR *)(dstCode + entry.offset) += value;
+		}
+#ifdef WIN_X64
+		else if (entry.type == PICO_INST_PATCH_DIFF) {
+			*(DWORD *)(dstCode + entry.offset) += (DWORD)((ULONG_PTR)dstData - (ULONG_PTR)dstCode);
+		}
+#endif
+		else if (entry.type == PICO_INST_COPY && entry.option == PICO_CONTEXT_CODE) {
+			__movsb((unsigned char *)dstCode + entry.dst_offset, (unsigned char *)src + hdr->rsrcOffset + entry.src_offset, entry.total);
+		}
+	}
+}
+
+/*
+ * Is this directive only about the code section? These are the ones PicoLoadCode replays.
+ */
+static BOOL PicoCodeDirective(PICO_CURSOR * entry) {
+	if (entry->type == PICO_INST_PATCH)
+		return entry->option == PICO_PATCH_TEXT_TEXT || entry->option == PICO_PATCH_TEXT_BASE;
+
+	if (entry->type == PICO_INST_COPY)
+		return entry->option == PICO_CONTEXT_CODE;
+
+	return entry->type == PICO_INST_PATCH_DIFF || entry->type == PICO_INST_EXPORT;
+}
+
+/*
+ * Step to the next directive that touches the data section.
+ */
+static BOOL PicoNextDataDirective(PICO_CURSOR * entry) {
+	while (PicoCursorNext(entry)) {
+		if (!PicoCodeDirective(entry))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/*
+ * Do two PICOs build the very same data section, function table included? Then code built from
+ * one works with a data section loaded from the other. Data copies are compared by the bytes
+ * they copy, wherever those sit in the resources. Directives are compared in order, so a vault
+ * and its compact form may not compare equal: the transcoder reorders patches by kind.
+ */
+BOOL PicoSameData(char * srcA, char * srcB) {
+	PICO_HDR    * hdrA = (PICO_HDR *)srcA;
+	PICO_HDR    * hdrB = (PICO_HDR *)srcB;
+	PICO_CURSOR   a;
+	PICO_CURSOR   b;
+	BOOL          moreA;
+	BOOL          moreB;
+
+	if (hdrA->dataLength != hdrB->dataLength)
+		return FALSE;
+
+	PicoCursorInit(&a, srcA);
+	PicoCursorInit(&b, srcB);
+
+	while (TRUE) {
+		moreA = PicoNextDataDirective(&a);
+		moreB = PicoNextDataDirective(&b);
+
+		if (!moreA || !moreB)
+			return moreA == moreB;
+
+		if (a.type != b.type || a.option != b.option)
+			return FALSE;
+
+		if (a.type == PICO_INST_COPY) {
+			char * bytesA = srcA + hdrA->rsrcOffset + a.src_offset;
+			char * bytesB = srcB + hdrB->rsrcOffset + b.src_offset;
+
+			if (a.dst_offset != b.dst_offset || a.total != b.total)
+				return FALSE;
+
+			for (int x = 0; x < a.total; x++) {
+				if (bytesA[x] != bytesB[x])
+					return FALSE;
+			}
+		}
+		else if (a.type == PICO_INST_LL || a.type == PICO_INST_GPA) {
+			for (int x = 0; a.arg[x] || b.arg[x]; x++) {
+				if (a.arg[x] != b.arg[x])
+					return FALSE;
+			}
+		}
+		else if (a.offset != b.offset) {
+			return FALSE;
 		}
+	}
+}
 
-		entry = NEXT_PICO_DIRECTIVE(entry);
+/*
+ * Figure out how many bytes a PICO occupies: the header and directive stream, plus whatever
+ * part of the resources the copy directives read from.
+ */
+int PicoVaultSize(char * src) {
+	PICO_CURSOR   entry;
+	PICO_HDR    * hdr = (PICO_HDR *)src;
+	int           size = hdr->rsrcOffset;
+
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_COPY) {
+			if (hdr->rsrcOffset + entry.src_offset + entry.total > size)
+				size = hdr->rsrcOffset + entry.src_offset + entry.total;
+		}
 	}
+
+	/* the cursor stops right after the directive stream */
+	if ((int)(entry.next - src) > size)
+		size = (int)(entry.next - src);
+
+	return size;
+}
+
+/*
+ * Count the LL and GPA directives of a PICO, i.e. the LoadLibraryA and GetProcAddress calls
+ * a load (or a reset that resolves its imports again) makes through IMPORTFUNCS.
+ */
+void PicoResolveCount(char * src, int * libraries, int * procedures) {
+	PICO_CURSOR entry;
+
+	*libraries  = 0;
+	*procedures = 0;
+
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_LL)
+			(*libraries)++;
+		else if (entry.type == PICO_INST_GPA)
+			(*procedures)++;
+	}
+}
+
+/*
+ * Move an already loaded image to new code and data addresses. The image bytes were copied
+ * as-is from oldCode/oldData, so every patch only needs the difference between the new and
+ * old bases added. The function table is resolved again through funcs, which also validates
+ * that every import still exists in this process: returns FALSE if any of them did not resolve.
+ */
+BOOL PicoRebase(IMPORTFUNCS * funcs, char * src, char * dstCode, char * dstData, char * oldCode, char * oldData) {
+	PICO_CURSOR   entry;
+	HANDLE        module  = NULL;
+	char        * address = NULL;
+	ULONG_PTR     codeDelta = (ULONG_PTR)dstCode - (ULONG_PTR)oldCode;
+	ULONG_PTR     dataDelta = (ULONG_PTR)dstData - (ULONG_PTR)oldData;
+	BOOL          valid = TRUE;
+
+	PicoCursorInit(&entry, src);
+	while (PicoCursorNext(&entry)) {
+		if (entry.type == PICO_INST_PATCH) {
+			char    * base  = (entry.option == PICO_PATCH_TEXT_TEXT || entry.option == PICO_PATCH_TEXT_BASE) ? dstCode : dstData;
+			ULONG_PTR delta = (entry.option == PICO_PATCH_TEXT_TEXT || entry.option == PICO_PATCH_BASE_TEXT) ? codeDelta : dataDelta;
+
+			*(ULONG_PTR *)(base + entry.offset) += delta;
+		}
+		else if (entry.type == PICO_INST_PATCH_FUNC) {
+			ULONG_PTR value;
+
+			if (entry.option == PICO_PATCHF_FUNC) {
+				value = (ULONG_PTR)address;
+			}
+			else {
+				ULONG_PTR * table = (ULONG_PTR *)funcs;
+				value = table[entry.option - 1];
+			}
+
+			*(ULONG_PTR *)(dstData + entry.offset) = value;
+		}
+#ifdef WIN_X64
+		else if (entry.type == PICO_INST_PATCH_DIFF) {
+			*(DWORD *)(dstCode + entry.offset) += (DWORD)(dataDelta - codeDelta);
+		}
+#endif
+		else if (entry.type == PICO_INST_LL) {
+			module = funcs->LoadLibraryA(entry.arg);
+			if (module == NULL)
+				valid = FALSE;
+		}
+		else if (entry.type == PICO_INST_GPA) {
+			address = (char *)funcs->GetProcAddress(module, entry.arg);
+			if (address == NULL)
+				valid = FALSE;
+		}
+	}
+
+	return valid;
 }
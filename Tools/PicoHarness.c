@@ -0,0 +1,787 @@
+/*
+ * PICO Manager Library - Loader harness
+ *
+ * Host-side equivalence and performance gate for the loader. Every vault of
+ * a generated corpus, plus any vault files given on the command line, is
+ * loaded by the reference interpreter (PicoLoad) and by each faster path
+ * the library has, at randomized code and data bases:
+ *
+ *   compact  - the vault transcoded to the compact (v2) encoding
+ *   parts    - PicoLoadSplit and PicoLoadPart, parts of each phase run in
+ *              shuffled order (skipped for vaults PicoSplitCount refuses)
+ *   rebase   - loaded elsewhere, copied over and moved by PicoRebase
+ *   reset    - PicoResetData (cached imports) and PicoLoadCode over a
+ *              scribbled image
+ *
+ * Code, data and the fixed-up function table slots must be byte-identical
+ * to the reference. The time each path takes is reported as a speedup over
+ * PicoLoad, with parts run on a fixed set of threads started once, along
+ * with the vaults each path skipped. Exits with 1 on any mismatch.
+ *
+ * With -m, the reference load times are also fitted to the cost model of
+ * picoinfo and written to the given model file.
+ *
+ *   picoharness [-n vaults] [-i iterations] [-p parts] [-s seed] [-m model.txt] [vault.bin ...]
+ *
+ * Unlike the other tools this one is built with mingw and runs on Windows:
+ * it links picorun.c and uses the Win32 memory, thread and counter APIs.
+ */
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../Include/PicoManager.h"
+#include "../Source/PicoInternal.h"
+
+#define PICO_TRANSCODE_LIBRARY
+#include "PicoTranscode.c"
+
+/* Random slack in front of every base, so bases are not page aligned */
+#define HARNESS_BASE_SLACK 0x10000
+
+/* Largest generated code section */
+#define HARNESS_MAX_CODE (4 * 1024 * 1024)
+
+/* Cost model terms fitted from the reference: per load, per byte copied, per relocation, per other directive */
+#define FIT_TERMS 4
+
+/* Paths compared against the reference */
+#define PATH_REFERENCE 0
+#define PATH_COMPACT   1
+#define PATH_PARTS     2
+#define PATH_REBASE    3
+#define PATH_RESET     4
+#define PATH_COUNT     5
+
+static const char* pathNames[PATH_COUNT] = { "reference", "compact", "parts", "rebase", "reset" };
+
+typedef struct {
+    DWORD checked;
+    DWORD mismatches;
+    DWORD skipped;                          /* Vaults the path does not apply to */
+    LONGLONG ticks;                         /* Time the path took */
+    LONGLONG referenceTicks;                /* Time PicoLoad took over the same runs */
+} PATH_RESULT;
+
+/* Normal equations of the least squares fit of PicoLoad time, in counter ticks */
+typedef struct {
+    double xtx[FIT_TERMS][FIT_TERMS];
+    double xty[FIT_TERMS];
+    DWORD samples;
+} MODEL_FIT;
+
+/* One destination: a region and the randomized code and data bases inside it */
+typedef struct {
+    char* region;
+    SIZE_T regionSize;
+    char* code;
+    char* data;
+} IMAGE;
+
+typedef struct {
+    char* vault;
+    char* code;
+    char* data;
+    int phase;
+    PICO_LOAD_RANGE* range;
+} PART_ARGS;
+
+/* A thread of the fixed set running parts, woken once per phase */
+typedef struct {
+    HANDLE thread;
+    HANDLE start;
+    PART_ARGS* args;                        /* Part to run, NULL to exit */
+} PART_WORKER;
+
+static ULONGLONG rngState;
+
+static PART_WORKER partWorkers[PICO_LOAD_PARTS_MAX];
+static int partWorkerCount;
+static HANDLE partsDone;
+
+/* ========================================================================
+ * HELPER FUNCTIONS
+ * ======================================================================== */
+
+static ULONGLONG Random(void) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    return rngState;
+}
+
+static DWORD RandomBelow(DWORD limit) {
+    return limit ? (DWORD)(Random() % limit) : 0;
+}
+
+static LONGLONG Now(void) {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+static DWORD Hash(const char* text, DWORD seed) {
+    DWORD hash = seed ^ 0x811C9DC5;
+    while (*text) {
+        hash = (hash ^ (unsigned char)*text++) * 0x01000193;
+    }
+    return hash;
+}
+
+/*
+ * Deterministic stand-ins for the real import functions: every path must fill
+ * in the same values, and no library of a real vault gets loaded.
+ */
+static HMODULE WINAPI FakeLoadLibraryA(LPCSTR name) {
+    return (HMODULE)(ULONG_PTR)(Hash(name, 0) | 1);
+}
+
+static FARPROC WINAPI FakeGetProcAddress(HMODULE module, LPCSTR name) {
+    return (FARPROC)(ULONG_PTR)(Hash(name, (DWORD)(ULONG_PTR)module) | 2);
+}
+
+static void ImageInit(IMAGE* image, SIZE_T codeSize, SIZE_T dataSize) {
+    image->regionSize = codeSize + dataSize + 2 * HARNESS_BASE_SLACK + 0x1000;
+    image->region = VirtualAlloc(NULL, image->regionSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!image->region) {
+        fprintf(stderr, "picoharness: VirtualAlloc failed\n");
+        exit(1);
+    }
+
+    /* Code bases only need 16 byte alignment in a shared block, data sections get their own pages */
+    image->code = image->region + (RandomBelow(HARNESS_BASE_SLACK) & ~15);
+    image->data = image->region + HARNESS_BASE_SLACK + codeSize + (RandomBelow(HARNESS_BASE_SLACK) & ~0xFFF);
+}
+
+static void ImageFree(IMAGE* image) {
+    VirtualFree(image->region, 0, MEM_RELEASE);
+}
+
+/*
+ * Puts an image back to what the manager hands the loader: fresh, zeroed pages.
+ */
+static void ImageClear(IMAGE* image, PICO_HDR* hdr) {
+    memset(image->code, 0, hdr->codeLength);
+    memset(image->data, 0, hdr->dataLength);
+}
+
+/* ========================================================================
+ * CORPUS FUNCTIONS
+ * ======================================================================== */
+
+static void Directive(BUFFER* vault, int type, int option, const void* body, int length) {
+    PICO_DIRECTIVE_HDR hdr;
+
+    hdr.type = (char)type;
+    hdr.option = (char)option;
+    hdr.length = (short)(sizeof(PICO_DIRECTIVE_HDR) + length);
+
+    for (size_t i = 0; i < sizeof(hdr); i++) PutByte(vault, ((unsigned char*)&hdr)[i]);
+    for (int i = 0; i < length; i++) PutByte(vault, ((const unsigned char*)body)[i]);
+}
+
+static void DirectiveInts(BUFFER* vault, int type, int option, int a, int b, int c) {
+    int body[3] = { a, b, c };
+    Directive(vault, type, option, body, (type == PICO_INST_COPY) ? 12 : (type == PICO_INST_EXPORT) ? 8 : 4);
+}
+
+static void DirectiveString(BUFFER* vault, int type, const char* text) {
+    char body[64] = { 0 };
+    int length = (int)strlen(text) + 1;
+
+    memcpy(body, text, length);
+    Directive(vault, type, 0, body, (length + 3) & ~3);
+}
+
+static void Shuffle(int* values, int count) {
+    for (int i = count - 1; i > 0; i--) {
+        int j = RandomBelow(i + 1);
+        int value = values[i];
+        values[i] = values[j];
+        values[j] = value;
+    }
+}
+
+/*
+ * Picks distinct pointer-sized slots in [0, size) with the given odds in 256.
+ */
+static int PickSlots(int size, int odds, int* slots, BOOL* used) {
+    int count = 0;
+
+    for (int offset = 0; offset + (int)sizeof(ULONG_PTR) <= size; offset += sizeof(ULONG_PTR)) {
+        if (!used[offset / sizeof(ULONG_PTR)] && RandomBelow(256) < (DWORD)odds) {
+            used[offset / sizeof(ULONG_PTR)] = TRUE;
+            slots[count++] = offset;
+        }
+    }
+
+    Shuffle(slots, count);
+    return count;
+}
+
+static void Relocation(BUFFER* vault, int context, int slot) {
+    if (context == PICO_CONTEXT_DATA) {
+        DirectiveInts(vault, PICO_INST_PATCH, RandomBelow(2) ? PICO_PATCH_BASE_TEXT : PICO_PATCH_BASE_BASE, slot, 0, 0);
+        return;
+    }
+#ifdef WIN_X64
+    if (RandomBelow(4) == 0) {
+        DirectiveInts(vault, PICO_INST_PATCH_DIFF, 0, slot, 0, 0);
+        return;
+    }
+#endif
+    DirectiveInts(vault, PICO_INST_PATCH, RandomBelow(2) ? PICO_PATCH_TEXT_TEXT : PICO_PATCH_TEXT_BASE, slot, 0, 0);
+}
+
+/*
+ * Emits the relocations of a section that no later copy overwrites: slots
+ * inside the first copied bytes, or past the bytes any copy reaches. Each one
+ * that qualifies goes out with the given odds in 256.
+ */
+static void Relocations(BUFFER* vault, int context, int* slots, BOOL* emitted, int count, int copied, int total, int odds) {
+    for (int i = 0; i < count; i++) {
+        if (emitted[i]) continue;
+        if (slots[i] + (int)sizeof(ULONG_PTR) > copied && slots[i] < total) continue;
+        if (RandomBelow(256) >= (DWORD)odds) continue;
+
+        Relocation(vault, context, slots[i]);
+        emitted[i] = TRUE;
+    }
+}
+
+/*
+ * Generates a full format vault shaped like a Crystal Palace build: section
+ * copies in pieces, relocations in no particular order, imports and exports.
+ * A quarter of them interleave relocations with the copies, each behind the
+ * copy that writes its bytes, an order PicoSplitCount refuses.
+ */
+static char* GenerateVault(size_t* vaultSize) {
+    static const char* libraries[] = { "KERNEL32", "ADVAPI32", "WS2_32", "WININET", "NTDLL", "USER32" };
+    static const char* procedures[] = { "VirtualAlloc", "Sleep", "CreateFileA", "ReadFile", "WriteFile", "CloseHandle",
+        "connect", "send", "recv", "InternetOpenA", "RtlCopyMemory", "GetTickCount", "OpenProcessToken", "MessageBoxA" };
+
+    /* Mostly small modules, with the odd multi-megabyte one */
+    int codeLength = 0x400 + RandomBelow((RandomBelow(8) == 0) ? HARNESS_MAX_CODE : 0x10000);
+    int dataLength = 0x100 + RandomBelow(codeLength / 2);
+    int codeBytes = codeLength - RandomBelow(codeLength / 16);
+    int dataBytes = dataLength - RandomBelow(dataLength / 2);
+
+    int* codeSlots = malloc(sizeof(int) * (codeLength / sizeof(ULONG_PTR) + 1));
+    int* dataSlots = malloc(sizeof(int) * (dataLength / sizeof(ULONG_PTR) + 1));
+    int* funcSlots = malloc(sizeof(int) * (dataLength / sizeof(ULONG_PTR) + 1));
+    BOOL* codeUsed = calloc(codeLength / sizeof(ULONG_PTR) + 1, sizeof(BOOL));
+    BOOL* dataUsed = calloc(dataLength / sizeof(ULONG_PTR) + 1, sizeof(BOOL));
+    BOOL* codeEmitted = calloc(codeLength / sizeof(ULONG_PTR) + 1, sizeof(BOOL));
+    BOOL* dataEmitted = calloc(dataLength / sizeof(ULONG_PTR) + 1, sizeof(BOOL));
+    if (!codeSlots || !dataSlots || !funcSlots || !codeUsed || !dataUsed || !codeEmitted || !dataEmitted) Fail("out of memory");
+
+    int codeCount = PickSlots(codeLength, 1 + RandomBelow(48), codeSlots, codeUsed);
+    int funcCount = PickSlots(dataLength, 8, funcSlots, dataUsed);
+    int dataCount = PickSlots(dataLength, 24, dataSlots, dataUsed);
+
+    BUFFER vault = { 0 };
+    PICO_HDR hdr = { codeLength, dataLength, 0, (int)RandomBelow(codeLength) };
+    for (size_t i = 0; i < sizeof(hdr); i++) PutByte(&vault, 0);
+
+    /* Copies: the code section then the data section, each in a few pieces */
+    BOOL interleaved = (RandomBelow(4) == 0);
+    for (int context = PICO_CONTEXT_CODE; context <= PICO_CONTEXT_DATA; context++) {
+        int total = (context == PICO_CONTEXT_CODE) ? codeBytes : dataBytes;
+        int base = (context == PICO_CONTEXT_CODE) ? 0 : codeBytes;
+        int pieces = 1 + RandomBelow(4);
+
+        for (int piece = 0, done = 0; piece < pieces && done < total; piece++) {
+            int length = (piece == pieces - 1) ? total - done : 1 + RandomBelow(total - done);
+            DirectiveInts(&vault, PICO_INST_COPY, context, base + done, done, length);
+            done += length;
+
+            if (!interleaved) continue;
+            if (context == PICO_CONTEXT_CODE) {
+                Relocations(&vault, context, codeSlots, codeEmitted, codeCount, done, total, 128);
+            } else {
+                Relocations(&vault, context, dataSlots, dataEmitted, dataCount, done, total, 128);
+            }
+        }
+    }
+
+    /* Relocations, the rest of them for interleaved vaults */
+    Relocations(&vault, PICO_CONTEXT_CODE, codeSlots, codeEmitted, codeCount, codeLength, codeLength, 256);
+    Relocations(&vault, PICO_CONTEXT_DATA, dataSlots, dataEmitted, dataCount, dataLength, dataLength, 256);
+
+    /* Imports: a library, then its procedures each followed by their function table slot */
+    for (int i = 0; i < funcCount;) {
+        DirectiveString(&vault, PICO_INST_LL, libraries[RandomBelow(sizeof(libraries) / sizeof(libraries[0]))]);
+
+        for (int count = 1 + RandomBelow(8); count > 0 && i < funcCount; count--, i++) {
+            if (RandomBelow(16) == 0) {
+                /* Slot filled straight from IMPORTFUNCS */
+                DirectiveInts(&vault, PICO_INST_PATCH_FUNC, 1 + RandomBelow(2), funcSlots[i], 0, 0);
+                continue;
+            }
+            DirectiveString(&vault, PICO_INST_GPA, procedures[RandomBelow(sizeof(procedures) / sizeof(procedures[0]))]);
+            DirectiveInts(&vault, PICO_INST_PATCH_FUNC, PICO_PATCHF_FUNC, funcSlots[i], 0, 0);
+        }
+    }
+
+    for (int count = RandomBelow(4); count > 0; count--) {
+        DirectiveInts(&vault, PICO_INST_EXPORT, 0, (int)Random(), RandomBelow(codeLength), 0);
+    }
+    Directive(&vault, PICO_INST_COMPLETE, 0, NULL, 0);
+
+    /* Resources: the raw section bytes */
+    hdr.rsrcOffset = (int)vault.length;
+    for (int i = 0; i < codeBytes + dataBytes; i++) {
+        PutByte(&vault, (unsigned char)Random());
+    }
+    memcpy(vault.bytes, &hdr, sizeof(hdr));
+
+    free(codeSlots);
+    free(dataSlots);
+    free(funcSlots);
+    free(codeUsed);
+    free(dataUsed);
+    free(codeEmitted);
+    free(dataEmitted);
+
+    *vaultSize = vault.length;
+    return (char*)vault.bytes;
+}
+
+static char* ReadVault(const char* path, size_t* vaultSize) {
+    FILE* in = fopen(path, "rb");
+    if (!in) return NULL;
+
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+
+    char* vault = malloc(size > 0 ? size : 1);
+    if (vault && fread(vault, 1, size, in) != (size_t)size) {
+        free(vault);
+        vault = NULL;
+    }
+    fclose(in);
+
+    *vaultSize = size;
+    return vault;
+}
+
+/* ========================================================================
+ * MODEL FUNCTIONS
+ * ======================================================================== */
+
+/*
+ * Adds one reference load to the fit. Compact vaults are left out, the model
+ * counts full format directives.
+ */
+static void FitAdd(MODEL_FIT* fit, char* vault, LONGLONG ticks) {
+    PICO_DIRECTIVE_HDR* entry = FIRST_PICO_DIRECTIVE(vault);
+    double terms[FIT_TERMS] = { 1.0, (double)PicoCopySize(vault), 0.0, 0.0 };
+
+    if (entry->type == PICO_INST_COMPACT) return;
+
+    while (entry->type != PICO_INST_COMPLETE) {
+        if (entry->type == PICO_INST_PATCH || entry->type == PICO_INST_PATCH_DIFF) {
+            terms[2] += 1.0;
+        } else {
+            terms[3] += 1.0;
+        }
+        entry = NEXT_PICO_DIRECTIVE(entry);
+    }
+
+    for (int i = 0; i < FIT_TERMS; i++) {
+        for (int j = 0; j < FIT_TERMS; j++) {
+            fit->xtx[i][j] += terms[i] * terms[j];
+        }
+        fit->xty[i] += terms[i] * (double)ticks;
+    }
+    fit->samples++;
+}
+
+/*
+ * Solves the fit and writes a picoinfo model file. Import costs cannot be
+ * measured with stand-in import functions and keep picoinfo's defaults.
+ */
+static BOOL FitWrite(MODEL_FIT* fit, const char* path, double nsPerTick) {
+    double a[FIT_TERMS][FIT_TERMS + 1];
+    double coefficients[FIT_TERMS];
+
+    if (fit->samples < FIT_TERMS) return FALSE;
+
+    for (int i = 0; i < FIT_TERMS; i++) {
+        for (int j = 0; j < FIT_TERMS; j++) a[i][j] = fit->xtx[i][j];
+        a[i][FIT_TERMS] = fit->xty[i];
+    }
+
+    /* Gaussian elimination with partial pivoting */
+    for (int column = 0; column < FIT_TERMS; column++) {
+        int pivot = column;
+        for (int row = column + 1; row < FIT_TERMS; row++) {
+            if (fabs(a[row][column]) > fabs(a[pivot][column])) pivot = row;
+        }
+        if (a[pivot][column] == 0.0) return FALSE;
+
+        for (int j = 0; j <= FIT_TERMS; j++) {
+            double value = a[column][j];
+            a[column][j] = a[pivot][j];
+            a[pivot][j] = value;
+        }
+
+        for (int row = 0; row < FIT_TERMS; row++) {
+            if (row == column) continue;
+            double factor = a[row][column] / a[column][column];
+            for (int j = column; j <= FIT_TERMS; j++) a[row][j] -= factor * a[column][j];
+        }
+    }
+
+    /* A cost below zero is noise */
+    for (int i = 0; i < FIT_TERMS; i++) {
+        coefficients[i] = a[i][FIT_TERMS] / a[i][i] * nsPerTick;
+        if (coefficients[i] < 0.0) coefficients[i] = 0.0;
+    }
+
+    FILE* out = fopen(path, "w");
+    if (!out) return FALSE;
+
+    fprintf(out, "base_ns %.3f\n", coefficients[0]);
+    fprintf(out, "copy_byte_ns %.6f\n", coefficients[1]);
+    fprintf(out, "relocation_ns %.3f\n", coefficients[2]);
+    fprintf(out, "directive_ns %.3f\n", coefficients[3]);
+    fclose(out);
+
+    printf("model: %lu samples, base %.1f ns, %.4f ns per byte, %.2f ns per relocation, %.2f ns per other directive -> %s\n",
+        (unsigned long)fit->samples, coefficients[0], coefficients[1], coefficients[2], coefficients[3], path);
+    return TRUE;
+}
+
+/* ========================================================================
+ * PATH FUNCTIONS
+ * ======================================================================== */
+
+static void RunPart(PART_ARGS* args) {
+    PicoLoadPart(NULL, args->vault, args->code, args->data, args->phase, args->range);
+}
+
+static DWORD WINAPI PartThread(LPVOID param) {
+    PART_WORKER* worker = (PART_WORKER*)param;
+
+    while (WaitForSingleObject(worker->start, INFINITE) == WAIT_OBJECT_0 && worker->args) {
+        RunPart(worker->args);
+        ReleaseSemaphore(partsDone, 1, NULL);
+    }
+    return 0;
+}
+
+/*
+ * Starts the threads that run parts 1 and up, like the manager's executor
+ * workers: thread creation is not part of what a load costs.
+ */
+static void PartWorkersStart(int count) {
+    partsDone = CreateSemaphoreA(NULL, 0, PICO_LOAD_PARTS_MAX, NULL);
+
+    for (int i = 0; i < count; i++) {
+        partWorkers[i].start = CreateSemaphoreA(NULL, 0, 1, NULL);
+        partWorkers[i].args = NULL;
+        partWorkers[i].thread = CreateThread(NULL, 0, PartThread, &partWorkers[i], 0, NULL);
+        if (!partsDone || !partWorkers[i].start || !partWorkers[i].thread) {
+            fprintf(stderr, "picoharness: cannot start part threads\n");
+            exit(1);
+        }
+    }
+    partWorkerCount = count;
+}
+
+static void PartWorkersStop(void) {
+    for (int i = 0; i < partWorkerCount; i++) {
+        partWorkers[i].args = NULL;
+        ReleaseSemaphore(partWorkers[i].start, 1, NULL);
+        WaitForSingleObject(partWorkers[i].thread, INFINITE);
+        CloseHandle(partWorkers[i].thread);
+        CloseHandle(partWorkers[i].start);
+    }
+    CloseHandle(partsDone);
+}
+
+/*
+ * Loads in parts a vault PicoSplitCount accepted. The stream is cut once,
+ * then threaded runs every phase like the manager does; otherwise the parts
+ * of each phase run one by one in shuffled order, which must not matter
+ * either.
+ */
+static void LoadParts(IMPORTFUNCS* funcs, char* vault, IMAGE* image, int copyBytes, int patches, int parts, BOOL threaded) {
+    PICO_LOAD_RANGE ranges[2 * PICO_LOAD_PARTS_MAX];
+    PART_ARGS args[PICO_LOAD_PARTS_MAX];
+    int order[PICO_LOAD_PARTS_MAX];
+
+    PicoLoadSplit(vault, copyBytes, patches, parts, ranges);
+
+    for (int phase = PICO_LOAD_COPY; phase <= PICO_LOAD_PATCH; phase++) {
+        for (int i = 0; i < parts; i++) {
+            PART_ARGS part = { vault, image->code, image->data, phase, &ranges[phase * parts + i] };
+            args[i] = part;
+            order[i] = i;
+        }
+
+        if (!threaded) {
+            Shuffle(order, parts);
+            for (int i = 0; i < parts; i++) RunPart(&args[order[i]]);
+            continue;
+        }
+
+        for (int i = 1; i < parts; i++) {
+            partWorkers[i - 1].args = &args[i];
+            ReleaseSemaphore(partWorkers[i - 1].start, 1, NULL);
+        }
+        RunPart(&args[0]);
+
+        for (int i = 1; i < parts; i++) WaitForSingleObject(partsDone, INFINITE);
+    }
+
+    PicoLoadPart(funcs, vault, image->code, image->data, PICO_LOAD_IMPORTS, NULL);
+}
+
+/*
+ * Compares an image to the reference. Reports the first differing byte and
+ * whether the function table slots match.
+ */
+static BOOL CheckImage(const char* name, int path, IMAGE* image, PICO_HDR* hdr, char* refCode, char* refData, ULONG_PTR* refSlots, char* vault) {
+    int importCount = PicoImportCount(vault);
+    ULONG_PTR* slots = malloc(sizeof(ULONG_PTR) * (importCount + 1));
+    BOOL slotsMatch;
+    BOOL match = TRUE;
+
+    PicoCaptureImports(vault, image->data, slots);
+    slotsMatch = memcmp(slots, refSlots, sizeof(ULONG_PTR) * importCount) == 0;
+    free(slots);
+
+    for (int i = 0; i < hdr->codeLength && match; i++) {
+        if (image->code[i] != refCode[i]) {
+            printf("MISMATCH %s %s: code +0x%x\n", name, pathNames[path], i);
+            match = FALSE;
+        }
+    }
+    for (int i = 0; i < hdr->dataLength && match; i++) {
+        if (image->data[i] != refData[i]) {
+            printf("MISMATCH %s %s: data +0x%x%s\n", name, pathNames[path], i, slotsMatch ? "" : " (function table)");
+            match = FALSE;
+        }
+    }
+
+    return match;
+}
+
+/*
+ * Runs every path over one vault, iterations times each.
+ */
+static void RunVault(const char* name, char* vault, size_t vaultSize, int iterations, int parts, PATH_RESULT* results, MODEL_FIT* fit) {
+    IMPORTFUNCS funcs = { FakeLoadLibraryA, FakeGetProcAddress };
+    PICO_HDR* hdr = (PICO_HDR*)vault;
+    IMAGE image;
+    IMAGE other;
+
+    PICO_DIRECTIVE_HDR* first = FIRST_PICO_DIRECTIVE(vault);
+    char* compact = NULL;
+    int copyBytes;
+    int patches;
+
+    if (first->type != PICO_INST_COMPACT) {
+        unsigned char* out;
+        int count;
+        TranscodeVault((unsigned char*)vault, vaultSize, &out, &count);
+        compact = (char*)out;
+    } else {
+        results[PATH_COMPACT].skipped++;
+    }
+
+    /* The manager loads these whole, which the reference already covers */
+    BOOL splittable = PicoSplitCount(vault, &copyBytes, &patches);
+    if (!splittable) results[PATH_PARTS].skipped++;
+
+    ImageInit(&image, hdr->codeLength, hdr->dataLength);
+    ImageInit(&other, hdr->codeLength, hdr->dataLength);
+
+    char* refCode = malloc(hdr->codeLength);
+    char* refData = malloc(hdr->dataLength);
+    ULONG_PTR* refSlots = malloc(sizeof(ULONG_PTR) * (PicoImportCount(vault) + 1));
+
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        LONGLONG start;
+        LONGLONG reference;
+
+        /* Reference */
+        ImageClear(&image, hdr);
+        start = Now();
+        PicoLoad(&funcs, vault, image.code, image.data);
+        reference = Now() - start;
+        FitAdd(fit, vault, reference);
+        results[PATH_REFERENCE].checked++;
+        results[PATH_REFERENCE].ticks += reference;
+        results[PATH_REFERENCE].referenceTicks += reference;
+
+        memcpy(refCode, image.code, hdr->codeLength);
+        memcpy(refData, image.data, hdr->dataLength);
+        PicoCaptureImports(vault, image.data, refSlots);
+
+        /* Compact encoding */
+        if (compact) {
+            ImageClear(&image, hdr);
+            start = Now();
+            PicoLoad(&funcs, compact, image.code, image.data);
+            results[PATH_COMPACT].ticks += Now() - start;
+            results[PATH_COMPACT].referenceTicks += reference;
+            results[PATH_COMPACT].checked++;
+            if (!CheckImage(name, PATH_COMPACT, &image, hdr, refCode, refData, refSlots, vault)) results[PATH_COMPACT].mismatches++;
+        }
+
+        /* Parts, shuffled for equivalence and threaded for timing; one check covers both */
+        if (splittable) {
+            BOOL match;
+
+            ImageClear(&image, hdr);
+            LoadParts(&funcs, vault, &image, copyBytes, patches, 1 + RandomBelow(parts), FALSE);
+            match = CheckImage(name, PATH_PARTS, &image, hdr, refCode, refData, refSlots, vault);
+
+            ImageClear(&image, hdr);
+            start = Now();
+            LoadParts(&funcs, vault, &image, copyBytes, patches, parts, TRUE);
+            results[PATH_PARTS].ticks += Now() - start;
+            results[PATH_PARTS].referenceTicks += reference;
+            results[PATH_PARTS].checked++;
+            if (!CheckImage(name, PATH_PARTS, &image, hdr, refCode, refData, refSlots, vault)) match = FALSE;
+            if (!match) results[PATH_PARTS].mismatches++;
+        }
+
+        /* Relocation by delta from an image loaded at other bases */
+        ImageClear(&other, hdr);
+        PicoLoad(&funcs, vault, other.code, other.data);
+        ImageClear(&image, hdr);
+        start = Now();
+        memcpy(image.code, other.code, hdr->codeLength);
+        memcpy(image.data, other.data, hdr->dataLength);
+        PicoRebase(&funcs, vault, image.code, image.data, other.code, other.data);
+        results[PATH_REBASE].ticks += Now() - start;
+        results[PATH_REBASE].referenceTicks += reference;
+        results[PATH_REBASE].checked++;
+        if (!CheckImage(name, PATH_REBASE, &image, hdr, refCode, refData, refSlots, vault)) results[PATH_REBASE].mismatches++;
+
+        /* Reset over a scribbled image, imports from the captured slots */
+        memset(image.code, 0x5A, hdr->codeLength);
+        memset(image.data, 0xA5, hdr->dataLength);
+        start = Now();
+        PicoLoadCode(vault, image.code, image.data);
+        PicoResetData(&funcs, vault, image.code, image.data, refSlots);
+        results[PATH_RESET].ticks += Now() - start;
+        results[PATH_RESET].referenceTicks += reference;
+        results[PATH_RESET].checked++;
+        if (!CheckImage(name, PATH_RESET, &image, hdr, refCode, refData, refSlots, vault)) results[PATH_RESET].mismatches++;
+
+        /* New bases for the next round */
+        ImageFree(&image);
+        ImageFree(&other);
+        ImageInit(&image, hdr->codeLength, hdr->dataLength);
+        ImageInit(&other, hdr->codeLength, hdr->dataLength);
+    }
+
+    ImageFree(&image);
+    ImageFree(&other);
+    free(refCode);
+    free(refData);
+    free(refSlots);
+    free(compact);
+}
+
+/* ========================================================================
+ * MAIN
+ * ======================================================================== */
+
+int main(int argc, char* argv[]) {
+    PATH_RESULT results[PATH_COUNT] = { 0 };
+    MODEL_FIT fit = { 0 };
+    const char* modelPath = NULL;
+    SYSTEM_INFO system;
+    LARGE_INTEGER frequency;
+    int generated = 64;
+    int iterations = 4;
+    int files = 0;
+    int parts;
+
+    GetSystemInfo(&system);
+    parts = (system.dwNumberOfProcessors < PICO_LOAD_PARTS_MAX) ? (int)system.dwNumberOfProcessors : PICO_LOAD_PARTS_MAX;
+    rngState = (ULONGLONG)Now() | 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-' && i + 1 < argc) {
+            int value = atoi(argv[i + 1]);
+
+            if (argv[i][1] == 'n') generated = value;
+            else if (argv[i][1] == 'i') iterations = value;
+            else if (argv[i][1] == 'p') parts = value;
+            else if (argv[i][1] == 's') rngState = (ULONGLONG)(unsigned int)value | 1;
+            else if (argv[i][1] == 'm') modelPath = argv[i + 1];
+            else break;
+
+            argv[i++] = NULL;
+            argv[i] = NULL;
+        }
+    }
+
+    if (parts < 1 || parts > PICO_LOAD_PARTS_MAX || iterations < 1) {
+        fprintf(stderr, "usage: %s [-n vaults] [-i iterations] [-p parts] [-s seed] [-m model.txt] [vault.bin ...]\n", argv[0]);
+        return 1;
+    }
+
+    PartWorkersStart(parts - 1);
+
+    for (int i = 1; i < argc; i++) {
+        size_t size;
+        char* vault;
+
+        if (!argv[i]) continue;
+
+        vault = ReadVault(argv[i], &size);
+        if (!vault || size < sizeof(PICO_HDR) + sizeof(PICO_DIRECTIVE_HDR)) {
+            fprintf(stderr, "picoharness: cannot read %s\n", argv[i]);
+            return 1;
+        }
+
+        RunVault(argv[i], vault, size, iterations, parts, results, &fit);
+        free(vault);
+        files++;
+    }
+
+    for (int i = 0; i < generated; i++) {
+        char name[32];
+        size_t size;
+        char* vault = GenerateVault(&size);
+
+        snprintf(name, sizeof(name), "generated#%d", i);
+        RunVault(name, vault, size, iterations, parts, results, &fit);
+        free(vault);
+    }
+
+    PartWorkersStop();
+    QueryPerformanceFrequency(&frequency);
+
+    printf("%d generated and %d file vaults, %d iterations, %d parts\n", generated, files, iterations, parts);
+    printf("%-10s %8s %10s %8s %12s %8s\n", "path", "checked", "mismatches", "skipped", "time (ms)", "speedup");
+
+    DWORD mismatches = 0;
+    for (int path = 0; path < PATH_COUNT; path++) {
+        PATH_RESULT* result = &results[path];
+        double ms = result->ticks * 1000.0 / frequency.QuadPart;
+
+        printf("%-10s %8lu %10lu %8lu %12.2f %7.2fx\n", pathNames[path], (unsigned long)result->checked, (unsigned long)result->mismatches,
+            (unsigned long)result->skipped, ms, result->ticks ? (double)result->referenceTicks / result->ticks : 0.0);
+        mismatches += result->mismatches;
+    }
+
+    if (modelPath && !FitWrite(&fit, modelPath, 1e9 / frequency.QuadPart)) {
+        fprintf(stderr, "picoharness: cannot fit or write %s\n", modelPath);
+        return 1;
+    }
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,290 @@
+/*
+ * PICO Manager Library - Vault inspector
+ *
+ * Host-side tool that parses vaults in either format and reports what is
+ * inside: directive counts by type and option, copies and how many of them
+ * could be coalesced, imports per module, exports, and a predicted load cost
+ * from a linear model. Limits turn it into a build pipeline check:
+ *
+ *   picoinfo [-m model.txt] [-t max_us] [-r max_relocations] [-i max_imports] <vault.bin ...>
+ *
+ * Exits with 2 if any vault exceeds a limit, 1 on errors and unknown
+ * options. The model file holds "name value" lines, see INFO_MODEL;
+ * picoharness -m writes one calibrated on the machine it runs on.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PICO_CURSOR_CHECKED
+#include "../Include/PicoCursor.h"
+
+/* Modules reported per vault; a warning counts the LoadLibraryA calls past it */
+#define INFO_MAX_MODULES 64
+
+/* Cost model, nanoseconds */
+typedef struct {
+    double base;                            /* Per load */
+    double copyByte;                        /* Per byte copied */
+    double relocation;                      /* Per PATCH/PATCH_DIFF */
+    double directive;                       /* Per directive other than a relocation */
+    double loadLibrary;                     /* Per LoadLibraryA */
+    double getProcAddress;                  /* Per GetProcAddress */
+} INFO_MODEL;
+
+typedef struct {
+    const char* name;
+    int procedures;
+} INFO_MODULE;
+
+/* ========================================================================
+ * PARSING FUNCTIONS
+ * ======================================================================== */
+
+static void LoadModel(const char* path, INFO_MODEL* model) {
+    FILE* in = fopen(path, "r");
+    char name[64];
+    double value;
+
+    if (!in) {
+        fprintf(stderr, "picoinfo: cannot open %s\n", path);
+        exit(1);
+    }
+
+    while (fscanf(in, "%63s %lf", name, &value) == 2) {
+        if (!strcmp(name, "base_ns")) model->base = value;
+        else if (!strcmp(name, "copy_byte_ns")) model->copyByte = value;
+        else if (!strcmp(name, "relocation_ns")) model->relocation = value;
+        else if (!strcmp(name, "directive_ns")) model->directive = value;
+        else if (!strcmp(name, "loadlibrary_ns")) model->loadLibrary = value;
+        else if (!strcmp(name, "getprocaddress_ns")) model->getProcAddress = value;
+    }
+    fclose(in);
+}
+
+/* ========================================================================
+ * REPORT FUNCTIONS
+ * ======================================================================== */
+
+static const char* TypeName(int type) {
+    static const char* names[] = { "COMPLETE", "PATCH", "COPY", "LL", "GPA", "PATCH_DIFF", "PATCH_FUNC", "EXPORT" };
+    return (type >= 0 && type <= PICO_INST_EXPORT) ? names[type] : "UNKNOWN";
+}
+
+static const char* OptionName(int type, int option) {
+    static const char* patches[] = { "TEXT_TEXT", "TEXT_BASE", "BASE_TEXT", "BASE_BASE" };
+
+    if (type == PICO_INST_PATCH && option >= 0 && option <= PICO_PATCH_BASE_BASE) return patches[option];
+    if (type == PICO_INST_COPY) return (option == PICO_CONTEXT_CODE) ? "code" : "data";
+    if (type == PICO_INST_PATCH_FUNC) return (option == PICO_PATCHF_FUNC) ? "procedure" : "IMPORTFUNCS";
+    return "";
+}
+
+/*
+ * Reports one vault. Returns 1 if it exceeds a limit, -1 if it is malformed.
+ */
+static int Report(const char* path, unsigned char* vault, size_t size, INFO_MODEL* model, double maxMicroseconds, long maxRelocations, long maxImports) {
+    static long counts[256][256];
+    PICO_HDR* hdr = (PICO_HDR*)vault;
+    INFO_MODULE modules[INFO_MAX_MODULES];
+    INFO_MODULE* module = NULL;
+    PICO_CURSOR cursor;
+    int moduleCount = 0;
+    long untracked = 0;
+
+    long directives = 0;
+    long copies = 0;
+    long coalescible = 0;
+    long long copyBytes[2] = { 0, 0 };
+    long relocations = 0;
+    long libraries = 0;
+    long procedures = 0;
+    long tableSlots = 0;
+    int previousContext = -1;
+    long long previousSrc = 0;
+    long long previousDst = 0;
+
+    memset(counts, 0, sizeof(counts));
+
+    cursor.end = (char*)vault + size;
+    if (size < sizeof(PICO_HDR) + sizeof(PICO_DIRECTIVE_HDR)) {
+        fprintf(stderr, "picoinfo: %s: not a vault\n", path);
+        return -1;
+    }
+
+    PicoCursorInit(&cursor, (char*)vault);
+    if (cursor.malformed) {
+        fprintf(stderr, "picoinfo: %s: not a vault\n", path);
+        return -1;
+    }
+
+    printf("%s: %s format, %lu bytes\n", path, cursor.strings ? "compact" : "full", (unsigned long)size);
+    printf("  code 0x%x, data 0x%x, entry 0x%x, resources at 0x%x\n", hdr->codeLength, hdr->dataLength, hdr->entryAddress, hdr->rsrcOffset);
+
+    printf("  exports:\n");
+    while (PicoCursorNext(&cursor)) {
+        directives++;
+        /* Options only tell patches, copies and function table slots apart */
+        if (cursor.type == PICO_INST_PATCH || cursor.type == PICO_INST_COPY) {
+            counts[(unsigned char)cursor.type][(unsigned char)cursor.option]++;
+        } else if (cursor.type == PICO_INST_PATCH_FUNC) {
+            counts[cursor.type][cursor.option != PICO_PATCHF_FUNC]++;
+        } else {
+            counts[(unsigned char)cursor.type][0]++;
+        }
+
+        if (cursor.type == PICO_INST_COPY) {
+            int context = (cursor.option == PICO_CONTEXT_CODE) ? 0 : 1;
+
+            /* Picks up exactly where the previous copy into the same section stopped */
+            if (context == previousContext && cursor.src_offset == previousSrc && cursor.dst_offset == previousDst) {
+                coalescible++;
+            }
+
+            copies++;
+            copyBytes[context] += cursor.total;
+            previousContext = context;
+            previousSrc = (long long)cursor.src_offset + cursor.total;
+            previousDst = (long long)cursor.dst_offset + cursor.total;
+        } else if (cursor.type == PICO_INST_PATCH || cursor.type == PICO_INST_PATCH_DIFF) {
+            relocations++;
+        } else if (cursor.type == PICO_INST_LL) {
+            libraries++;
+            module = NULL;
+            for (int i = 0; i < moduleCount; i++) {
+                if (!strcmp(modules[i].name, cursor.arg)) module = &modules[i];
+            }
+            if (!module && moduleCount < INFO_MAX_MODULES) {
+                module = &modules[moduleCount++];
+                module->name = cursor.arg;
+                module->procedures = 0;
+            } else if (!module) {
+                untracked++;
+            }
+        } else if (cursor.type == PICO_INST_GPA) {
+            procedures++;
+            if (module) module->procedures++;
+        } else if (cursor.type == PICO_INST_PATCH_FUNC && cursor.option != PICO_PATCHF_FUNC) {
+            tableSlots++;
+        } else if (cursor.type == PICO_INST_EXPORT) {
+            printf("    tag %d at 0x%x\n", cursor.tag, cursor.offset);
+        }
+    }
+
+    /* The walk stops early on an overrun and on a record type it does not know */
+    if (cursor.malformed || cursor.type != PICO_INST_COMPLETE) {
+        fprintf(stderr, "picoinfo: %s: malformed directive stream\n", path);
+        return -1;
+    }
+
+    printf("  directives: %ld\n", directives);
+    for (int type = 0; type < 256; type++) {
+        for (int option = 0; option < 256; option++) {
+            if (counts[type][option]) {
+                printf("    %-10s %-11s %8ld\n", TypeName(type), OptionName(type, option), counts[type][option]);
+            }
+        }
+    }
+
+    printf("  copies: %ld, %lld code bytes, %lld data bytes, %ld coalescible\n", copies, copyBytes[0], copyBytes[1], coalescible);
+    printf("  relocations: %ld\n", relocations);
+    printf("  imports: %ld libraries (%d%s distinct), %ld procedures, %ld IMPORTFUNCS slots\n", libraries, moduleCount, untracked ? "+" : "", procedures, tableSlots);
+    for (int i = 0; i < moduleCount; i++) {
+        printf("    %-24s %6d\n", modules[i].name, modules[i].procedures);
+    }
+    if (untracked) {
+        fprintf(stderr, "picoinfo: %s: more than %d distinct libraries, %ld LoadLibraryA calls not listed per module\n", path, INFO_MAX_MODULES, untracked);
+    }
+
+    double copyCost = model->copyByte * (double)(copyBytes[0] + copyBytes[1]);
+    double relocationCost = model->relocation * relocations;
+    double importCost = model->loadLibrary * libraries + model->getProcAddress * procedures;
+    double directiveCost = model->base + model->directive * (directives - relocations);
+    double total = (copyCost + relocationCost + importCost + directiveCost) / 1000.0;
+
+    printf("  predicted load: %.1f us (copies %.1f, relocations %.1f, imports %.1f, directives %.1f)\n",
+        total, copyCost / 1000.0, relocationCost / 1000.0, importCost / 1000.0, directiveCost / 1000.0);
+
+    int exceeded = 0;
+    if (maxMicroseconds >= 0 && total > maxMicroseconds) {
+        printf("  LIMIT predicted load %.1f us > %.1f us\n", total, maxMicroseconds);
+        exceeded = 1;
+    }
+    if (maxRelocations >= 0 && relocations > maxRelocations) {
+        printf("  LIMIT relocations %ld > %ld\n", relocations, maxRelocations);
+        exceeded = 1;
+    }
+    if (maxImports >= 0 && procedures + tableSlots > maxImports) {
+        printf("  LIMIT imports %ld > %ld\n", procedures + tableSlots, maxImports);
+        exceeded = 1;
+    }
+    return exceeded;
+}
+
+/* ========================================================================
+ * MAIN
+ * ======================================================================== */
+
+static void Usage(const char* program) {
+    fprintf(stderr, "usage: %s [-m model.txt] [-t max_us] [-r max_relocations] [-i max_imports] <vault.bin ...>\n", program);
+}
+
+int main(int argc, char* argv[]) {
+    /* Defaults until calibrated: warm caches, imports from modules already loaded */
+    INFO_MODEL model = { 200.0, 0.1, 2.0, 3.0, 1500.0, 150.0 };
+    double maxMicroseconds = -1;
+    long maxRelocations = -1;
+    long maxImports = -1;
+    int status = 0;
+    int files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-') {
+            /* Every option takes a value; anything else would be taken for a vault or ignored */
+            if (!argv[i][1] || argv[i][2] || !strchr("mtri", argv[i][1]) || i + 1 >= argc) {
+                fprintf(stderr, "picoinfo: bad option %s\n", argv[i]);
+                Usage(argv[0]);
+                return 1;
+            }
+
+            if (argv[i][1] == 'm') LoadModel(argv[i + 1], &model);
+            else if (argv[i][1] == 't') maxMicroseconds = atof(argv[i + 1]);
+            else if (argv[i][1] == 'r') maxRelocations = atol(argv[i + 1]);
+            else maxImports = atol(argv[i + 1]);
+            i++;
+            continue;
+        }
+
+        FILE* in = fopen(argv[i], "rb");
+        if (!in) {
+            fprintf(stderr, "picoinfo: cannot open %s\n", argv[i]);
+            return 1;
+        }
+
+        fseek(in, 0, SEEK_END);
+        long size = ftell(in);
+        fseek(in, 0, SEEK_SET);
+
+        unsigned char* vault = malloc(size > 0 ? size : 1);
+        if (!vault || fread(vault, 1, size, in) != (size_t)size) {
+            fprintf(stderr, "picoinfo: cannot read %s\n", argv[i]);
+            return 1;
+        }
+        fclose(in);
+
+        int result = Report(argv[i], vault, size, &model, maxMicroseconds, maxRelocations, maxImports);
+        if (result < 0) return 1;
+        if (result > 0) status = 2;
+
+        free(vault);
+        files++;
+    }
+
+    if (files == 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    return status;
+}
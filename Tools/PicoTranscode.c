@@ -0,0 +1,292 @@
+/*
+ * PICO Manager Library - Transcoder
+ *
+ * Host-side tool that rewrites a vault in the full directive format as a
+ * compact (v2) vault. The loader accepts both, so this is purely a size
+ * optimization done at build time:
+ *
+ *   picotranscode <in.bin> <out.bin>
+ *
+ * Consecutive patches are grouped by kind, sorted and stored as delta-encoded
+ * varints, consecutive copies of the same context are batched and LL/GPA
+ * arguments go into a deduplicated string table. See Include/PicoFormat.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../Include/PicoFormat.h"
+
+/* Growable byte buffer the stream and string table are built in */
+typedef struct {
+    unsigned char* bytes;
+    size_t length;
+    size_t capacity;
+} BUFFER;
+
+/* ========================================================================
+ * ENCODING FUNCTIONS
+ * ======================================================================== */
+
+static void Fail(const char* message) {
+    fprintf(stderr, "picotranscode: %s\n", message);
+    exit(1);
+}
+
+static void PutByte(BUFFER* buffer, unsigned char value) {
+    if (buffer->length == buffer->capacity) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+        buffer->bytes = realloc(buffer->bytes, buffer->capacity);
+        if (!buffer->bytes) Fail("out of memory");
+    }
+    buffer->bytes[buffer->length++] = value;
+}
+
+static void PutVarint(BUFFER* buffer, unsigned int value) {
+    while (value >= 0x80) {
+        PutByte(buffer, (unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    PutByte(buffer, (unsigned char)value);
+}
+
+static void PutRecord(BUFFER* buffer, int type, int option, unsigned int count) {
+    PutByte(buffer, (unsigned char)type);
+    PutByte(buffer, (unsigned char)option);
+    PutVarint(buffer, count);
+}
+
+/*
+ * Offset of a string in the string table, adding it the first time it is seen.
+ */
+static unsigned int PutString(BUFFER* strings, const char* value) {
+    size_t length = strlen(value) + 1;
+    size_t offset = 0;
+
+    while (offset < strings->length) {
+        if (strcmp((const char*)strings->bytes + offset, value) == 0) return (unsigned int)offset;
+        offset += strlen((const char*)strings->bytes + offset) + 1;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        PutByte(strings, (unsigned char)value[i]);
+    }
+    return (unsigned int)offset;
+}
+
+static int CompareOffsets(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static int IsPatch(PICO_DIRECTIVE_HDR* entry) {
+    return entry->type == PICO_INST_PATCH || entry->type == PICO_INST_PATCH_DIFF;
+}
+
+/*
+ * Emits a run of PATCH and PATCH_DIFF directives as one record per kind.
+ * Patches add to what is at their offset, so their order does not matter.
+ */
+static void PutPatchGroup(BUFFER* stream, PICO_DIRECTIVE_HDR** group, int count) {
+    static const int types[] = { PICO_INST_PATCH, PICO_INST_PATCH_DIFF };
+    int* offsets = malloc(sizeof(int) * count);
+    if (!offsets) Fail("out of memory");
+
+    for (int t = 0; t < 2; t++) {
+        int type = types[t];
+
+        for (int option = 0; option < 256; option++) {
+            int total = 0;
+
+            for (int i = 0; i < count; i++) {
+                if (group[i]->type == type && (unsigned char)group[i]->option == option) {
+                    offsets[total++] = ((PICO_DIRECTIVE_PATCH*)group[i])->offset;
+                }
+            }
+            if (total == 0) continue;
+
+            qsort(offsets, total, sizeof(int), CompareOffsets);
+
+            PutRecord(stream, type, option, total);
+            for (int i = 0; i < total; i++) {
+                PutVarint(stream, offsets[i] - (i ? offsets[i - 1] : 0));
+            }
+        }
+    }
+
+    free(offsets);
+}
+
+/*
+ * Encodes the directive stream of a full format vault. Returns the number of
+ * directives read and leaves the first byte after PICO_INST_COMPLETE in *end.
+ */
+static int Transcode(unsigned char* vault, size_t size, BUFFER* stream, BUFFER* strings, size_t* end) {
+    PICO_DIRECTIVE_HDR** list = NULL;
+    int count = 0;
+    PICO_DIRECTIVE_HDR* entry = FIRST_PICO_DIRECTIVE(vault);
+
+    /* Collect the directives first so runs can be looked at as a whole */
+    while (1) {
+        if ((unsigned char*)entry + sizeof(PICO_DIRECTIVE_HDR) > vault + size) Fail("truncated directive stream");
+        if (entry->type == PICO_INST_COMPLETE) break;
+        if (entry->type == PICO_INST_COMPACT) Fail("vault is already compact");
+        if (entry->length < (int)sizeof(PICO_DIRECTIVE_HDR)) Fail("bad directive length");
+
+        list = realloc(list, sizeof(PICO_DIRECTIVE_HDR*) * (count + 1));
+        if (!list) Fail("out of memory");
+        list[count++] = entry;
+
+        entry = NEXT_PICO_DIRECTIVE(entry);
+    }
+    *end = (unsigned char*)entry + sizeof(PICO_DIRECTIVE_HDR) - vault;
+
+    for (int i = 0; i < count;) {
+        PICO_DIRECTIVE_HDR* first = list[i];
+        int run = 1;
+
+        if (IsPatch(first)) {
+            while (i + run < count && IsPatch(list[i + run])) run++;
+            PutPatchGroup(stream, list + i, run);
+        } else if (first->type == PICO_INST_PATCH_FUNC) {
+            /* Slots are filled in order, so only ascending runs are merged */
+            while (i + run < count && list[i + run]->type == first->type && list[i + run]->option == first->option &&
+                   ((PICO_DIRECTIVE_PATCH*)list[i + run])->offset >= ((PICO_DIRECTIVE_PATCH*)list[i + run - 1])->offset) {
+                run++;
+            }
+
+            PutRecord(stream, first->type, first->option, run);
+            for (int j = 0; j < run; j++) {
+                int previous = j ? ((PICO_DIRECTIVE_PATCH*)list[i + j - 1])->offset : 0;
+                PutVarint(stream, ((PICO_DIRECTIVE_PATCH*)list[i + j])->offset - previous);
+            }
+        } else if (first->type == PICO_INST_COPY) {
+            while (i + run < count && list[i + run]->type == first->type && list[i + run]->option == first->option) run++;
+
+            PutRecord(stream, first->type, first->option, run);
+            for (int j = 0; j < run; j++) {
+                PICO_DIRECTIVE_COPY* copy = (PICO_DIRECTIVE_COPY*)list[i + j];
+                PutVarint(stream, copy->src_offset);
+                PutVarint(stream, copy->dst_offset);
+                PutVarint(stream, copy->total);
+            }
+        } else if (first->type == PICO_INST_LL || first->type == PICO_INST_GPA) {
+            while (i + run < count && list[i + run]->type == first->type && list[i + run]->option == first->option) run++;
+
+            PutRecord(stream, first->type, first->option, run);
+            for (int j = 0; j < run; j++) {
+                PutVarint(stream, PutString(strings, (const char*)list[i + j] + sizeof(PICO_DIRECTIVE_HDR)));
+            }
+        } else if (first->type == PICO_INST_EXPORT) {
+            PICO_DIRECTIVE_EXPORT* export = (PICO_DIRECTIVE_EXPORT*)first;
+
+            PutRecord(stream, first->type, first->option, 1);
+            PutVarint(stream, ((unsigned int)export->tag << 1) ^ (unsigned int)(export->tag >> 31));
+            PutVarint(stream, export->offset);
+        } else {
+            Fail("unknown directive");
+        }
+
+        i += run;
+    }
+
+    PutByte(stream, PICO_INST_COMPLETE);
+    free(list);
+    return count;
+}
+
+/*
+ * Rewrites a full format vault as a compact one in a new buffer the caller
+ * frees. Returns its size and the number of directives read in *count.
+ */
+static size_t TranscodeVault(unsigned char* vault, size_t size, unsigned char** result, int* count) {
+    PICO_HDR* hdr = (PICO_HDR*)vault;
+    BUFFER stream = { 0 };
+    BUFFER strings = { 0 };
+    BUFFER body = { 0 };
+    size_t end;
+
+    if (size < sizeof(PICO_HDR) + sizeof(PICO_DIRECTIVE_HDR)) Fail("input is not a vault");
+
+    *count = Transcode(vault, size, &stream, &strings, &end);
+
+    if (hdr->rsrcOffset < (int)end || hdr->rsrcOffset > (int)size) Fail("bad resource offset");
+
+    /* String table first, then the records */
+    PutVarint(&body, (unsigned int)strings.length);
+    for (size_t i = 0; i < strings.length; i++) PutByte(&body, strings.bytes[i]);
+    for (size_t i = 0; i < stream.length; i++) PutByte(&body, stream.bytes[i]);
+
+    size_t directives = sizeof(PICO_HDR) + sizeof(PICO_DIRECTIVE_COMPACT) + body.length;
+    size_t padding = (4 - (directives & 3)) & 3;
+    size_t resources = size - hdr->rsrcOffset;
+    unsigned char* out = calloc(1, directives + padding + resources);
+    if (!out) Fail("out of memory");
+
+    PICO_HDR* outHdr = (PICO_HDR*)out;
+    PICO_DIRECTIVE_COMPACT* compact = (PICO_DIRECTIVE_COMPACT*)(out + sizeof(PICO_HDR));
+
+    *outHdr = *hdr;
+    compact->hdr.type = PICO_INST_COMPACT;
+    compact->hdr.option = PICO_COMPACT_VERSION;
+    compact->hdr.length = sizeof(PICO_DIRECTIVE_COMPACT);
+    compact->streamLength = (int)body.length;
+    memcpy(out + sizeof(PICO_HDR) + sizeof(PICO_DIRECTIVE_COMPACT), body.bytes, body.length);
+
+    /* Resources keep their layout, so copy source offsets stay valid */
+    outHdr->rsrcOffset = (int)(directives + padding);
+    memcpy(out + outHdr->rsrcOffset, vault + hdr->rsrcOffset, resources);
+
+    free(body.bytes);
+    free(stream.bytes);
+    free(strings.bytes);
+
+    *result = out;
+    return outHdr->rsrcOffset + resources;
+}
+
+/* ========================================================================
+ * MAIN
+ * ======================================================================== */
+
+/* Tools that include this file to transcode in-process define PICO_TRANSCODE_LIBRARY */
+#ifndef PICO_TRANSCODE_LIBRARY
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <in.bin> <out.bin>\n", argv[0]);
+        return 1;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) Fail("cannot open input");
+
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+
+    unsigned char* vault = malloc(size > 0 ? size : 1);
+    if (!vault || fread(vault, 1, size, in) != (size_t)size) Fail("cannot read input");
+    fclose(in);
+
+    unsigned char* out;
+    int count;
+    size_t outSize = TranscodeVault(vault, size, &out, &count);
+
+    FILE* output = fopen(argv[2], "wb");
+    if (!output) Fail("cannot open output");
+    if (fwrite(out, 1, outSize, output) != outSize) Fail("cannot write output");
+    fclose(output);
+
+    printf("%s: %d directives, %d -> %d bytes of directives, %ld -> %ld bytes total\n",
+        argv[2], count, ((PICO_HDR*)vault)->rsrcOffset - (int)sizeof(PICO_HDR), ((PICO_HDR*)out)->rsrcOffset - (int)sizeof(PICO_HDR),
+        size, (long)outSize);
+
+    free(out);
+    free(vault);
+    return 0;
+}
+
+#endif